@@ -0,0 +1,962 @@
+/*
+  SwarmnessBench - reproduces the CPU and quality figures quoted in the
+  README. Every measurement renders the same deterministic test signal
+  (plucked sawtooth notes) through fresh instances, so runs on one machine
+  compare directly; absolute timings depend on the CPU.
+
+  Usage: SwarmnessBench <measurement>
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr int kBlockSize = 512;
+constexpr double kSeconds = 10.0;
+constexpr double kSettleSeconds = 0.5;  // Skipped by the output comparisons
+constexpr int kRuns = 5;                // Timings are the best of kRuns renders
+
+// E2 A2 D3 G3, one pluck every half second, the same on both channels
+juce::AudioBuffer<float> makeTestSignal(double sampleRate, double seconds) {
+    static constexpr std::array<double, 4> kNotes { 82.41, 110.0, 146.83, 196.0 };
+    const int numSamples = static_cast<int>(sampleRate * seconds);
+    const int noteLength = static_cast<int>(sampleRate * 0.5);
+    juce::AudioBuffer<float> signal(2, numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        const double t = static_cast<double>(i % noteLength) / sampleRate;
+        const double phase = t * kNotes[static_cast<size_t>((i / noteLength) % 4)];
+        const double saw = 2.0 * (phase - std::floor(phase)) - 1.0;
+        const float value = static_cast<float>(0.3 * saw * std::exp(-4.0 * t));
+        signal.setSample(0, i, value);
+        signal.setSample(1, i, value);
+    }
+    return signal;
+}
+
+// 110 Hz with eight 1/k harmonics, held for the whole signal
+juce::AudioBuffer<float> makeSustainedTone(double sampleRate, double seconds) {
+    const int numSamples = static_cast<int>(sampleRate * seconds);
+    juce::AudioBuffer<float> signal(2, numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        double value = 0.0;
+        for (int k = 1; k <= 8; ++k)
+            value += std::sin(juce::MathConstants<double>::twoPi * 110.0 * k * i / sampleRate) / k;
+        signal.setSample(0, i, static_cast<float>(0.15 * value));
+        signal.setSample(1, i, static_cast<float>(0.15 * value));
+    }
+    return signal;
+}
+
+double rmsAfterSettle(const juce::AudioBuffer<float>& buffer, double sampleRate) {
+    double sum = 0.0;
+    int count = 0;
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+        for (int i = static_cast<int>(sampleRate * kSettleSeconds); i < buffer.getNumSamples(); ++i, ++count)
+            sum += juce::square(static_cast<double>(buffer.getSample(ch, i)));
+    }
+    return std::sqrt(sum / juce::jmax(1, count));
+}
+
+// Formant peaks at 700, 1220 and 2600 Hz over a low floor
+double vowelEnvelope(double frequency) {
+    static constexpr std::array<std::array<double, 3>, 3> kFormants {{
+        { 700.0, 90.0, 1.0 }, { 1220.0, 110.0, 0.5 }, { 2600.0, 160.0, 0.25 }  // Hz, width, level
+    }};
+    double level = 0.01;
+    for (const auto& formant : kFormants)
+        level += formant[2] / (1.0 + juce::square((frequency - formant[0]) / formant[1]));
+    return level;
+}
+
+// Vowel-like source: 150 Hz harmonics shaped by vowelEnvelope
+constexpr double kVowelPitch = 150.0;
+
+juce::AudioBuffer<float> makeVowel(double sampleRate, double seconds) {
+    const int numSamples = static_cast<int>(sampleRate * seconds);
+    juce::AudioBuffer<float> signal(2, numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        double value = 0.0;
+        for (int k = 1; k * kVowelPitch < 0.45 * sampleRate; ++k)
+            value += vowelEnvelope(k * kVowelPitch)
+                   * std::sin(juce::MathConstants<double>::twoPi * kVowelPitch * k * i / sampleRate);
+        signal.setSample(0, i, static_cast<float>(0.1 * value));
+        signal.setSample(1, i, static_cast<float>(0.1 * value));
+    }
+    return signal;
+}
+
+// Amplitude of one frequency in the left channel: Hann-windowed DFT over
+// the second after the settle time
+double levelAt(const juce::AudioBuffer<float>& buffer, double frequency, double sampleRate) {
+    const int start = static_cast<int>(sampleRate * kSettleSeconds);
+    const int length = juce::jmin(static_cast<int>(sampleRate), buffer.getNumSamples() - start);
+    double re = 0.0, im = 0.0;
+    for (int i = 0; i < length; ++i) {
+        const double window = 0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * i / length);
+        const double angle = juce::MathConstants<double>::twoPi * frequency * i / sampleRate;
+        const double x = buffer.getSample(0, start + i) * window;
+        re += x * std::cos(angle);
+        im -= x * std::sin(angle);
+    }
+    return std::sqrt(re * re + im * im);
+}
+
+// RMS spread in dB of the output harmonics up to 4 kHz around the source
+// envelope, once the overall gain is taken out
+double envelopeDeviationDb(const juce::AudioBuffer<float>& output, double pitch, double sampleRate) {
+    std::vector<double> deviations;
+    for (int k = 1; k * pitch <= 4000.0; ++k) {
+        const double frequency = k * pitch;
+        deviations.push_back(20.0 * std::log10(juce::jmax(levelAt(output, frequency, sampleRate), 1.0e-12)
+                                               / vowelEnvelope(frequency)));
+    }
+    double mean = 0.0;
+    for (const double d : deviations)
+        mean += d / static_cast<double>(deviations.size());
+    double spread = 0.0;
+    for (const double d : deviations)
+        spread += juce::square(d - mean) / static_cast<double>(deviations.size());
+    return std::sqrt(spread);
+}
+
+void setParameter(juce::AudioProcessorValueTreeState& apvts, const juce::String& id, float value) {
+    auto* parameter = apvts.getParameter(id);
+    jassert(parameter != nullptr);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+struct Render {
+    juce::AudioBuffer<float> output;
+    double nsPerSample = std::numeric_limits<double>::max();  // Best of kRuns
+    int latency = 0;
+};
+
+using Settings = std::function<void(juce::AudioProcessorValueTreeState&)>;
+
+// Whole plugin: a fresh processor per run, parameters set before prepare
+Render renderProcessor(const Settings& settings, const juce::AudioBuffer<float>& input, double sampleRate) {
+    Render result;
+    for (int run = 0; run < kRuns; ++run) {
+        SwarmnesssAudioProcessor processor;
+        settings(processor.getAPVTS());
+        processor.setNonRealtime(false);
+        processor.setPlayConfigDetails(2, 2, sampleRate, kBlockSize);
+        processor.prepareToPlay(sampleRate, kBlockSize);
+
+        juce::AudioBuffer<float> output(input);
+        juce::MidiBuffer midi;
+        const auto start = std::chrono::steady_clock::now();
+        for (int pos = 0; pos < output.getNumSamples(); pos += kBlockSize) {
+            const int numSamples = juce::jmin(kBlockSize, output.getNumSamples() - pos);
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, pos, numSamples);
+            processor.processBlock(block, midi);
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        result.nsPerSample = juce::jmin(result.nsPerSample, elapsed.count() / output.getNumSamples());
+        result.latency = processor.getLatencySamples();
+        result.output = std::move(output);
+        processor.releaseResources();
+    }
+    return result;
+}
+
+void prepareEngine(GranularPitchShifter& engine) { engine.prepare(kSampleRate, kBlockSize); }
+void prepareEngine(PhaseVocoderShifter& engine) { engine.prepare(kSampleRate, kBlockSize); }
+void prepareEngine(AnalogOctave& engine) { engine.prepare(kSampleRate); }
+
+template <typename Engine>
+int getEngineLatency(const Engine& engine) { return engine.getLatencySamples(); }
+int getEngineLatency(const AnalogOctave&) { return 0; }
+
+// One pitch engine alone: a fresh instance per run, processStereo timed
+template <typename Engine>
+Render renderEngine(const std::function<void(Engine&)>& settings, const juce::AudioBuffer<float>& input) {
+    Render result;
+    for (int run = 0; run < kRuns; ++run) {
+        auto engine = std::make_unique<Engine>();
+        prepareEngine(*engine);
+        settings(*engine);
+
+        juce::AudioBuffer<float> output(input);
+        const auto start = std::chrono::steady_clock::now();
+        for (int pos = 0; pos < output.getNumSamples(); pos += kBlockSize) {
+            const int numSamples = juce::jmin(kBlockSize, output.getNumSamples() - pos);
+            engine->processStereo(output.getWritePointer(0, pos), output.getWritePointer(1, pos), numSamples);
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        result.nsPerSample = juce::jmin(result.nsPerSample, elapsed.count() / output.getNumSamples());
+        result.latency = getEngineLatency(*engine);
+        result.output = std::move(output);
+    }
+    return result;
+}
+
+// Struck bursts (900 + 1700 Hz, 10 ms decay), one every quarter second
+constexpr double kBurstInterval = 0.25;
+
+juce::AudioBuffer<float> makeBursts(double sampleRate, double seconds) {
+    const int numSamples = static_cast<int>(sampleRate * seconds);
+    const int interval = static_cast<int>(sampleRate * kBurstInterval);
+    juce::AudioBuffer<float> signal(2, numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        const double t = static_cast<double>(i % interval) / sampleRate;
+        const double value = 0.25 * std::exp(-t / 0.01)
+                           * (std::sin(juce::MathConstants<double>::twoPi * 900.0 * t)
+                              + std::sin(juce::MathConstants<double>::twoPi * 1700.0 * t));
+        signal.setSample(0, i, static_cast<float>(value));
+        signal.setSample(1, i, static_cast<float>(value));
+    }
+    return signal;
+}
+
+struct BurstStats {
+    double offset = 0.0;       // Loudest output peak against the delayed dry peak, samples
+    double extraDb = 0.0;      // Strongest other copy against the loudest, dB
+    double copies = 0.0;       // Envelope peaks within 12 dB of the loudest
+};
+
+// Averages over the bursts after the settle time. The envelope is the RMS
+// of 2 ms frames; a copy is a frame louder than both neighbours at least
+// three frames from the loudest
+BurstStats analyseBursts(const juce::AudioBuffer<float>& input, const Render& render, double sampleRate) {
+    const int interval = static_cast<int>(sampleRate * kBurstInterval);
+    const int frame = static_cast<int>(sampleRate * 0.002);
+    const int numFrames = interval / frame;
+    const int numBursts = input.getNumSamples() / interval - 1;
+    BurstStats stats;
+    int counted = 0;
+    for (int burst = static_cast<int>(kSettleSeconds / kBurstInterval); burst < numBursts; ++burst, ++counted) {
+        // Window starts a fifth of an interval ahead of the delayed dry burst
+        const int start = burst * interval + render.latency - interval / 5;
+        int dryPeak = 0;
+        for (int i = 1; i < interval; ++i)
+            if (std::abs(input.getSample(0, burst * interval + i)) > std::abs(input.getSample(0, burst * interval + dryPeak)))
+                dryPeak = i;
+
+        std::vector<double> envelope(static_cast<size_t>(numFrames), 0.0);
+        int loudest = 0;
+        for (int f = 0; f < numFrames; ++f) {
+            double sum = 0.0;
+            for (int i = start + f * frame; i < start + (f + 1) * frame; ++i)
+                sum += juce::square(static_cast<double>(render.output.getSample(0, i)));
+            envelope[static_cast<size_t>(f)] = std::sqrt(sum / frame);
+            if (envelope[static_cast<size_t>(f)] > envelope[static_cast<size_t>(loudest)])
+                loudest = f;
+        }
+        int loudestSample = start + loudest * frame;
+        for (int i = start + loudest * frame; i < start + (loudest + 1) * frame; ++i)
+            if (std::abs(render.output.getSample(0, i)) > std::abs(render.output.getSample(0, loudestSample)))
+                loudestSample = i;
+
+        const double peak = juce::jmax(envelope[static_cast<size_t>(loudest)], 1.0e-9);
+        double extra = 1.0e-9;
+        int copies = 1;
+        for (int f = 1; f + 1 < numFrames; ++f) {
+            const double e = envelope[static_cast<size_t>(f)];
+            if (std::abs(f - loudest) < 3 || e <= envelope[static_cast<size_t>(f - 1)] || e < envelope[static_cast<size_t>(f + 1)])
+                continue;
+            extra = juce::jmax(extra, e);
+            if (e >= peak * 0.25)
+                ++copies;
+        }
+        stats.offset += loudestSample - (burst * interval + dryPeak + render.latency);
+        stats.extraDb += 20.0 * std::log10(extra / peak);
+        stats.copies += copies;
+    }
+    stats.offset /= counted;
+    stats.extraDb /= counted;
+    stats.copies /= counted;
+    return stats;
+}
+
+// Residual of output against reference once their latencies are lined up,
+// in dB relative to the reference; -inf when they null exactly
+double nullDepthDb(const Render& output, const Render& reference, double sampleRate) {
+    const int offset = reference.latency - output.latency;
+    const int numSamples = output.output.getNumSamples();
+    double residual = 0.0, level = 0.0;
+    for (int ch = 0; ch < 2; ++ch) {
+        for (int i = static_cast<int>(sampleRate * kSettleSeconds); i < numSamples; ++i) {
+            if (i + offset < 0 || i + offset >= numSamples)
+                continue;
+            const double r = reference.output.getSample(ch, i + offset);
+            const double d = output.output.getSample(ch, i) - r;
+            residual += d * d;
+            level += r * r;
+        }
+    }
+    if (residual <= 0.0)
+        return -std::numeric_limits<double>::infinity();
+    return 10.0 * std::log10(residual / juce::jmax(level, 1.0e-30));
+}
+
+// Quality tiers: CPU of the whole plugin (GRANULAR, +1 OCT) per tier, and
+// how far each tier's output is from HQ
+int benchTiers() {
+    static constexpr std::array<const char*, 3> kNames { "ECO", "NORMAL", "HQ" };
+    const auto input = makeTestSignal(kSampleRate, kSeconds);
+    std::array<Render, 3> renders;
+    for (size_t tier = 0; tier < renders.size(); ++tier) {
+        renders[tier] = renderProcessor([tier](juce::AudioProcessorValueTreeState& apvts) {
+            setParameter(apvts, "quality", static_cast<float>(tier));
+        }, input, kSampleRate);
+    }
+
+    std::printf("Quality tiers: whole plugin, GRANULAR +1 OCT, %.0f Hz, %d-sample blocks\n\n",
+                kSampleRate, kBlockSize);
+    std::printf("%-8s %10s %9s %12s\n", "tier", "ns/sample", "latency", "vs HQ (dB)");
+    for (size_t tier = 0; tier < renders.size(); ++tier) {
+        std::printf("%-8s %10.1f %9d %12.1f\n", kNames[tier], renders[tier].nsPerSample,
+                    renders[tier].latency, nullDepthDb(renders[tier], renders[2], kSampleRate));
+    }
+    return 0;
+}
+
+// 48k Internal: whole-plugin CPU at each host rate with the pitch section
+// and chorus at the host rate or resampled to 44.1/48 kHz
+int benchRates() {
+    static constexpr std::array<double, 6> kRates { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    std::printf("48k Internal: whole plugin, GRANULAR +1 OCT, NORMAL, %d-sample blocks\n\n", kBlockSize);
+    std::printf("%-8s %-9s %10s %12s %9s\n", "rate", "internal", "ns/sample", "% realtime", "latency");
+    for (const double rate : kRates) {
+        const auto input = makeTestSignal(rate, kSeconds / 2.0);
+        for (const bool fixedRate : { false, true }) {
+            const auto render = renderProcessor([fixedRate](juce::AudioProcessorValueTreeState& apvts) {
+                setParameter(apvts, "fixedRate", fixedRate ? 1.0f : 0.0f);
+            }, input, rate);
+            std::printf("%-8.1f %-9s %10.1f %12.2f %9d\n", rate / 1000.0, fixedRate ? "on" : "off",
+                        render.nsPerSample, render.nsPerSample * rate * 1.0e-7, render.latency);
+        }
+    }
+    return 0;
+}
+
+// Granular engine alone (2 grains) at each octave and interpolation, the
+// setup the power-of-two delay buffer was timed with. Multiply by 1.05 for
+// ms per 2^20 samples. Then 2, 4 and 8 grains at +1 OCT against 2 grains
+// with the same read: the N-grain engine aimed for 4 grains at about 1.0x
+int benchGranular() {
+    static constexpr std::array<const char*, 5> kOctaves { "-2 OCT", "-1 OCT", "0", "+1 OCT", "+2 OCT" };
+    const auto input = makeTestSignal(kSampleRate, kSeconds);
+    auto granular = [&input](int mode, int interpolation, int grains) {
+        return renderEngine<GranularPitchShifter>([mode, interpolation, grains](GranularPitchShifter& shifter) {
+            shifter.setQuality(interpolation == 1 ? ProcessingQuality::HQ : ProcessingQuality::Normal);
+            shifter.setSincInterpolation(interpolation == 2);
+            shifter.setGrainCount(grains);
+            shifter.setOctaveMode(mode);
+        }, input);
+    };
+
+    std::printf("Granular engine: processStereo, 2 grains, %.0f Hz, %d-sample blocks (ns/sample)\n\n",
+                kSampleRate, kBlockSize);
+    std::printf("%-8s %10s %10s %10s\n", "octave", "linear", "Hermite", "sinc");
+    for (int mode = 0; mode < static_cast<int>(kOctaves.size()); ++mode) {
+        std::printf("%-8s", kOctaves[static_cast<size_t>(mode)]);
+        for (int interpolation = 0; interpolation < 3; ++interpolation)
+            std::printf(" %10.1f", granular(mode, interpolation, 2).nsPerSample);
+        std::printf("\n");
+    }
+
+    std::printf("\nGrain count: +1 OCT, ns/sample and cost relative to 2 grains\n\n");
+    std::printf("%-8s %16s %16s %16s\n", "grains", "linear", "Hermite", "sinc");
+    std::array<double, 3> twoGrains {};
+    for (const int grains : { 2, 4, 8 }) {
+        std::printf("%-8d", grains);
+        for (int interpolation = 0; interpolation < 3; ++interpolation) {
+            const double cost = granular(3, interpolation, grains).nsPerSample;
+            if (grains == 2)
+                twoGrains[static_cast<size_t>(interpolation)] = cost;
+            std::printf(" %10.1f %4.2fx", cost, cost / twoGrains[static_cast<size_t>(interpolation)]);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
+
+// One interpolated (L, R) frame of an interleaved ring: the low two lanes
+// of an SSE register or a NEON float32x2_t, as the engine reads its delay
+// line; plain floats elsewhere
+struct TapFrame {
+#if JUCE_USE_SSE_INTRINSICS
+    __m128 v;
+    static TapFrame zero() { return { _mm_setzero_ps() }; }
+    static TapFrame load(const float* p) { return { _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))) }; }
+    TapFrame operator+(TapFrame o) const { return { _mm_add_ps(v, o.v) }; }
+    TapFrame operator-(TapFrame o) const { return { _mm_sub_ps(v, o.v) }; }
+    TapFrame operator*(float g) const { return { _mm_mul_ps(v, _mm_set1_ps(g)) }; }
+    float left() const { return _mm_cvtss_f32(v); }
+    float right() const { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, 1)); }
+#elif JUCE_USE_ARM_NEON
+    float32x2_t v;
+    static TapFrame zero() { return { vdup_n_f32(0.0f) }; }
+    static TapFrame load(const float* p) { return { vld1_f32(p) }; }
+    TapFrame operator+(TapFrame o) const { return { vadd_f32(v, o.v) }; }
+    TapFrame operator-(TapFrame o) const { return { vsub_f32(v, o.v) }; }
+    TapFrame operator*(float g) const { return { vmul_n_f32(v, g) }; }
+    float left() const { return vget_lane_f32(v, 0); }
+    float right() const { return vget_lane_f32(v, 1); }
+#else
+    float l, r;
+    static TapFrame zero() { return { 0.0f, 0.0f }; }
+    static TapFrame load(const float* p) { return { p[0], p[1] }; }
+    TapFrame operator+(TapFrame o) const { return { l + o.l, r + o.r }; }
+    TapFrame operator-(TapFrame o) const { return { l - o.l, r - o.r }; }
+    TapFrame operator*(float g) const { return { l * g, r * g }; }
+    float left() const { return l; }
+    float right() const { return r; }
+#endif
+};
+
+template <typename T>
+T hermiteTap(T y0, T y1, T y2, T y3, float frac) {
+    const T c1 = (y2 - y0) * 0.5f;
+    const T c2 = y0 - y1 * 2.5f + y2 * 2.0f - y3 * 0.5f;
+    const T c3 = (y3 - y0) * 0.5f + (y1 - y2) * 1.5f;
+    return ((c3 * frac + c2) * frac + c1) * frac + y1;
+}
+
+// The grain tap stage alone at +1 OCT (10 ms grains, Hann window): the
+// input is written to the ring and every grain reads one windowed,
+// interpolated frame per sample. Index, fraction and window gain are
+// computed once per grain in both layouts, so only the ring layout differs
+Render renderTaps(const juce::AudioBuffer<float>& input, int grains, bool useHermite, bool interleaved) {
+    constexpr int kRingFrames = 8192, kMask = kRingFrames - 1, kGuard = 3;
+    const int grainSize = static_cast<int>(kSampleRate * GranularPitchShifter::kShortGrainMs / 1000.0);
+    const int latency = 2 * grainSize;
+    const float* window = GrainWindows::get(GrainWindows::Shape::Hann);
+    const float windowScale = static_cast<float>(GrainWindows::kSize) / static_cast<float>(grainSize);
+    const float grainGain = 2.0f / static_cast<float>(grains);
+    const int numSamples = input.getNumSamples();
+
+    Render result;
+    for (int run = 0; run < kRuns; ++run) {
+        std::vector<float> ringL(kRingFrames + kGuard, 0.0f), ringR(kRingFrames + kGuard, 0.0f);
+        std::vector<float> ring((kRingFrames + kGuard) * 2, 0.0f);
+        std::array<double, GranularPitchShifter::kMaxGrains> readPos {};
+        std::array<int, GranularPitchShifter::kMaxGrains> phase {};
+        for (size_t g = 0; g < static_cast<size_t>(grains); ++g) {
+            phase[g] = static_cast<int>(g) * grainSize / grains;
+            readPos[g] = kRingFrames - latency + 2.0 * phase[g];
+        }
+
+        juce::AudioBuffer<float> output(2, numSamples);
+        const float* inL = input.getReadPointer(0);
+        const float* inR = input.getReadPointer(1);
+        float* outL = output.getWritePointer(0);
+        float* outR = output.getWritePointer(1);
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0, writePos = 0; i < numSamples; ++i, writePos = (writePos + 1) & kMask) {
+            const auto w = static_cast<size_t>(writePos);
+            if (interleaved) {
+                ring[w * 2] = inL[i];
+                ring[w * 2 + 1] = inR[i];
+                if (writePos < kGuard) {
+                    ring[(w + kRingFrames) * 2] = inL[i];
+                    ring[(w + kRingFrames) * 2 + 1] = inR[i];
+                }
+            } else {
+                ringL[w] = inL[i];
+                ringR[w] = inR[i];
+                if (writePos < kGuard) {
+                    ringL[w + kRingFrames] = inL[i];
+                    ringR[w + kRingFrames] = inR[i];
+                }
+            }
+
+            TapFrame wet = TapFrame::zero();
+            float wetL = 0.0f, wetR = 0.0f;
+            for (size_t g = 0; g < static_cast<size_t>(grains); ++g) {
+                const int index = static_cast<int>(readPos[g]);
+                const float frac = static_cast<float>(readPos[g] - index);
+                const float gain = GrainWindows::lookup(window, static_cast<float>(phase[g]) * windowScale) * grainGain;
+                const auto first = static_cast<size_t>((index - (useHermite ? 1 : 0)) & kMask);
+                if (interleaved) {
+                    const float* x = ring.data() + first * 2;
+                    const TapFrame tap = useHermite
+                        ? hermiteTap(TapFrame::load(x), TapFrame::load(x + 2), TapFrame::load(x + 4), TapFrame::load(x + 6), frac)
+                        : TapFrame::load(x) + (TapFrame::load(x + 2) - TapFrame::load(x)) * frac;
+                    wet = wet + tap * gain;
+                } else {
+                    const float* l = ringL.data() + first;
+                    const float* r = ringR.data() + first;
+                    wetL += gain * (useHermite ? hermiteTap(l[0], l[1], l[2], l[3], frac) : l[0] + (l[1] - l[0]) * frac);
+                    wetR += gain * (useHermite ? hermiteTap(r[0], r[1], r[2], r[3], frac) : r[0] + (r[1] - r[0]) * frac);
+                }
+
+                readPos[g] += 2.0;
+                if (readPos[g] >= kRingFrames)
+                    readPos[g] -= kRingFrames;
+                if (++phase[g] == grainSize) {
+                    phase[g] = 0;
+                    readPos[g] = static_cast<double>((writePos + kRingFrames - latency) & kMask);
+                }
+            }
+            outL[i] = interleaved ? wet.left() : wetL;
+            outR[i] = interleaved ? wet.right() : wetR;
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        result.nsPerSample = juce::jmin(result.nsPerSample, elapsed.count() / numSamples);
+        result.output = std::move(output);
+    }
+    return result;
+}
+
+// Stereo layout: the tap stage from two planar rings (one scalar read per
+// channel, the layout before the interleaved delay line) and from one
+// interleaved ring (one 2-lane read per grain), with the largest output
+// difference between them. The engine row is processStereo at the same
+// setting; "planar est." adds the tap stage's planar cost back onto it.
+// The interleaved ring aimed for about half the planar stereo path, 0.50x
+int benchStereo() {
+    const auto input = makeTestSignal(kSampleRate, kSeconds);
+    std::printf("Stereo layout: +1 OCT, %.0f Hz (ns/sample)\n\n", kSampleRate);
+    std::printf("%-7s %-8s %8s %12s %7s %9s %9s %12s %7s\n", "grains", "read", "planar", "interleaved", "ratio",
+                "max diff", "engine", "planar est.", "ratio");
+    for (const bool hermite : { false, true }) {
+        for (const int grains : { 2, 4, 8 }) {
+            const auto planar = renderTaps(input, grains, hermite, false);
+            const auto interleaved = renderTaps(input, grains, hermite, true);
+            double difference = 0.0;
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < input.getNumSamples(); ++i)
+                    difference = juce::jmax(difference, std::abs(static_cast<double>(planar.output.getSample(ch, i))
+                                                                 - interleaved.output.getSample(ch, i)));
+
+            const auto engine = renderEngine<GranularPitchShifter>([grains, hermite](GranularPitchShifter& shifter) {
+                shifter.setQuality(hermite ? ProcessingQuality::HQ : ProcessingQuality::Normal);
+                shifter.setGrainCount(grains);
+                shifter.setOctaveMode(3);
+            }, input);
+            const double estimate = engine.nsPerSample + planar.nsPerSample - interleaved.nsPerSample;
+            std::printf("%-7d %-8s %8.1f %12.1f %6.2fx %9.1e %9.1f %12.1f %6.2fx\n", grains, hermite ? "Hermite" : "linear",
+                        planar.nsPerSample, interleaved.nsPerSample, interleaved.nsPerSample / planar.nsPerSample,
+                        difference, engine.nsPerSample, estimate, engine.nsPerSample / estimate);
+        }
+    }
+    return 0;
+}
+
+// Splice modes on a sustained harmonic tone at -1/+1 OCT (2 grains): CPU,
+// the search cost per WSOLA restart (two restarts per 10 ms grain) and the
+// output RMS, which drops where splices cancel
+int benchSplice() {
+    static constexpr std::array<const char*, 3> kModes { "FIXED", "WSOLA", "PSOLA" };
+    const auto input = makeSustainedTone(kSampleRate, kSeconds);
+    const double restartsPerSample = 2.0 / (GranularPitchShifter::kShortGrainMs * 0.001 * kSampleRate);
+    std::printf("Splice: 110 Hz harmonic tone (input RMS %.3f), 2 grains, %.0f Hz\n\n",
+                rmsAfterSettle(input, kSampleRate), kSampleRate);
+    std::printf("%-8s %-7s %10s %13s %8s\n", "octave", "splice", "ns/sample", "us/restart", "RMS");
+    for (const int mode : { 1, 3 }) {
+        double fixedCost = 0.0;
+        for (size_t splice = 0; splice < kModes.size(); ++splice) {
+            const auto render = renderEngine<GranularPitchShifter>([mode, splice](GranularPitchShifter& shifter) {
+                shifter.setOctaveMode(mode);
+                shifter.setGrainMode(static_cast<GranularPitchShifter::GrainMode>(splice));
+            }, input);
+            if (splice == 0)
+                fixedCost = render.nsPerSample;
+            char searchCost[16] = "-";  // WSOLA only, PSOLA restarts on its own cadence
+            if (splice == 1)
+                std::snprintf(searchCost, sizeof(searchCost), "%.2f",
+                              (render.nsPerSample - fixedCost) / restartsPerSample * 0.001);
+            std::printf("%-8s %-7s %10.1f %13s %8.3f\n", mode == 1 ? "-1 OCT" : "+1 OCT", kModes[splice],
+                        render.nsPerSample, searchCost, rmsAfterSettle(render.output, kSampleRate));
+        }
+    }
+    return 0;
+}
+
+// Formant preservation: a vowel shifted by the SPECTRAL engine (2048-sample
+// frames, 4x overlap), how far its harmonics stray from the vowel's envelope
+int benchFormant() {
+    const auto input = makeVowel(kSampleRate, 2.0);
+    std::printf("Formant: 150 Hz vowel (700/1220/2600 Hz), SPECTRAL 2048/4x, harmonics up to 4 kHz\n\n");
+    std::printf("%-8s %18s %18s\n", "octave", "formant off (dB)", "formant on (dB)");
+    for (const int mode : { 3, 1 }) {
+        std::printf("%-8s", mode == 3 ? "+1 OCT" : "-1 OCT");
+        for (const bool formant : { false, true }) {
+            const auto render = renderEngine<PhaseVocoderShifter>([mode, formant](PhaseVocoderShifter& shifter) {
+                shifter.setFrameSize(PhaseVocoderShifter::kMinOrder + 1);
+                shifter.setOverlap(4);
+                shifter.setFormantPreserve(formant);
+                shifter.setOctaveMode(mode);
+            }, input);
+            const double pitch = kVowelPitch * (mode == 3 ? 2.0 : 0.5);
+            std::printf(" %18.1f", envelopeDeviationDb(render.output, pitch, kSampleRate));
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
+
+// Pitch engines alone at +1 OCT: CPU per sample, relative to GRANULAR with
+// 2 grains (SPECTRAL with 2048-sample frames)
+int benchEngines() {
+    const auto input = makeTestSignal(kSampleRate, kSeconds);
+    auto spectral = [&input](int overlap, bool formant) {
+        return renderEngine<PhaseVocoderShifter>([overlap, formant](PhaseVocoderShifter& shifter) {
+            shifter.setFrameSize(PhaseVocoderShifter::kMinOrder + 1);
+            shifter.setOverlap(overlap);
+            shifter.setFormantPreserve(formant);
+            shifter.setOctaveMode(3);
+        }, input);
+    };
+    auto granular = [&input](int grains) {
+        return renderEngine<GranularPitchShifter>([grains](GranularPitchShifter& shifter) {
+            shifter.setGrainCount(grains);
+            shifter.setOctaveMode(3);
+        }, input);
+    };
+
+    const std::vector<std::pair<const char*, Render>> renders {
+        { "ANALOG", renderEngine<AnalogOctave>([](AnalogOctave& octave) { octave.setOctaveMode(3); }, input) },
+        { "GRANULAR 2 grains", granular(2) },
+        { "GRANULAR 8 grains", granular(8) },
+        { "SPECTRAL 4x", spectral(4, false) },
+        { "SPECTRAL 8x", spectral(8, false) },
+        { "SPECTRAL + Formant 4x", spectral(4, true) },
+        { "SPECTRAL + Formant 8x", spectral(8, true) },
+    };
+
+    std::printf("Pitch engines: stereo, +1 OCT, %.0f Hz, %d-sample blocks\n\n", kSampleRate, kBlockSize);
+    std::printf("%-22s %10s %9s\n", "engine", "ns/sample", "relative");
+    for (const auto& [name, render] : renders)
+        std::printf("%-22s %10.1f %8.2fx\n", name, render.nsPerSample, render.nsPerSample / renders[1].second.nsPerSample);
+    return 0;
+}
+
+// Onset sync on struck bursts: where the loudest copy of each attack lands
+// against the latency-delayed dry, how loud the strongest other copy is and
+// how many copies are heard
+int benchOnset() {
+    const auto input = makeBursts(kSampleRate, kSeconds);
+    std::printf("Onset sync: bursts every %.0f ms, %.0f Hz\n\n", kBurstInterval * 1000.0, kSampleRate);
+    std::printf("%-18s %-6s %12s %12s %8s\n", "setup", "onset", "offset (smp)", "extra (dB)", "copies");
+    struct Setup { const char* name; int mode; int grains; GranularPitchShifter::GrainMode splice; };
+    static constexpr std::array<Setup, 4> kSetups {{
+        { "+1 OCT 2 grains", 3, 2, GranularPitchShifter::GrainMode::Fixed },
+        { "-1 OCT 2 grains", 1, 2, GranularPitchShifter::GrainMode::Fixed },
+        { "+1 OCT WSOLA", 3, 2, GranularPitchShifter::GrainMode::Wsola },
+        { "+2 OCT 2 grains", 4, 2, GranularPitchShifter::GrainMode::Fixed },
+    }};
+    for (const auto& setup : kSetups) {
+        for (const bool onsetSync : { false, true }) {
+            const auto render = renderEngine<GranularPitchShifter>([&setup, onsetSync](GranularPitchShifter& shifter) {
+                shifter.setOctaveMode(setup.mode);
+                shifter.setGrainCount(setup.grains);
+                shifter.setGrainMode(setup.splice);
+                shifter.setOnsetSync(onsetSync);
+            }, input);
+            const auto stats = analyseBursts(input, render, kSampleRate);
+            std::printf("%-18s %-6s %12.0f %12.1f %8.1f\n", setup.name, onsetSync ? "on" : "off",
+                        stats.offset, stats.extraDb, stats.copies);
+        }
+    }
+    return 0;
+}
+
+// Cloud at +1 OCT with Panic and Chaos at half: CPU per density against the
+// 2-grain engine, and how many grains actually play (the pool holds 64)
+int benchCloud() {
+    struct Setup { float density; bool sinc; };
+    static constexpr std::array<Setup, 5> kSetups {{
+        { 0.0f, false }, { 0.25f, false }, { 0.5f, false }, { 1.0f, false }, { 1.0f, true }
+    }};
+    const auto input = makeTestSignal(kSampleRate, kSeconds);
+    auto configure = [](GranularPitchShifter& shifter, bool cloud, const Setup& setup) {
+        shifter.setOctaveMode(3);
+        shifter.setSincInterpolation(setup.sinc);
+        shifter.setCloud(cloud);
+        shifter.setCloudDensity(setup.density);
+        shifter.setCloudSpread(0.5f, 0.5f);
+    };
+    const auto grains = renderEngine<GranularPitchShifter>([&configure](GranularPitchShifter& shifter) {
+        configure(shifter, false, kSetups[0]);
+    }, input);
+
+    std::printf("Cloud: GRANULAR +1 OCT, Panic/Chaos 0.5, %.0f Hz, %d-sample blocks\n\n", kSampleRate, kBlockSize);
+    std::printf("%-24s %10s %12s %9s %12s\n", "setup", "ns/sample", "% realtime", "relative", "mean grains");
+    std::printf("%-24s %10.1f %12.2f %8.2fx %12s\n", "2 grains, linear", grains.nsPerSample,
+                grains.nsPerSample * kSampleRate * 1.0e-7, 1.0, "2");
+    for (const auto& setup : kSetups) {
+        const auto render = renderEngine<GranularPitchShifter>([&configure, &setup](GranularPitchShifter& shifter) {
+            configure(shifter, true, setup);
+        }, input);
+
+        // Untimed pass sampling the pool once per block
+        auto shifter = std::make_unique<GranularPitchShifter>();
+        prepareEngine(*shifter);
+        configure(*shifter, true, setup);
+        juce::AudioBuffer<float> output(input);
+        double active = 0.0;
+        int blocks = 0;
+        for (int pos = 0; pos + kBlockSize <= output.getNumSamples(); pos += kBlockSize, ++blocks) {
+            shifter->processStereo(output.getWritePointer(0, pos), output.getWritePointer(1, pos), kBlockSize);
+            active += shifter->getCloudGrainCount();
+        }
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "cloud density %.0f, %s", 8.0f + 56.0f * setup.density,
+                      setup.sinc ? "sinc" : "linear");
+        std::printf("%-24s %10.1f %12.2f %8.2fx %12.1f\n", name, render.nsPerSample,
+                    render.nsPerSample * kSampleRate * 1.0e-7, render.nsPerSample / grains.nsPerSample,
+                    active / juce::jmax(1, blocks));
+    }
+    return 0;
+}
+
+// Peak second difference of the left channel over [start, end): clicks and
+// steps show up as spikes far above a sine's own curvature
+double peakSecondDifference(const juce::AudioBuffer<float>& buffer, int start, int end) {
+    double peak = 0.0;
+    for (int i = juce::jmax(2, start); i < juce::jmin(end, buffer.getNumSamples()); ++i) {
+        const double d = static_cast<double>(buffer.getSample(0, i)) - 2.0 * buffer.getSample(0, i - 1)
+                       + buffer.getSample(0, i - 2);
+        peak = juce::jmax(peak, std::abs(d));
+    }
+    return peak;
+}
+
+// Grain size and latency budget changes on a 110 Hz sine, 4 grains: peak
+// second difference in the 200 ms before and after the change, one second in
+int benchBudget() {
+    struct Change {
+        const char* name;
+        bool engaged;
+        void (*apply)(GranularPitchShifter&);
+    };
+    static const std::array<Change, 3> kChanges {{
+        { "-1 -> -2 OCT (grain 10 -> 20 ms)", true, [](GranularPitchShifter& s) { s.setOctaveMode(0); } },
+        { "budget 40 -> 60 ms", true, [](GranularPitchShifter& s) { s.setLatencyBudget(60.0); } },
+        { "budget 40 -> 60 ms, disengaged", false, [](GranularPitchShifter& s) { s.setLatencyBudget(60.0); } },
+    }};
+    const int numSamples = static_cast<int>(kSampleRate * 1.5);
+    const int changeAt = static_cast<int>(kSampleRate / kBlockSize) * kBlockSize;
+    const int window = static_cast<int>(kSampleRate * 0.2);
+    juce::AudioBuffer<float> sine(2, numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        const auto value = static_cast<float>(0.5 * std::sin(juce::MathConstants<double>::twoPi * 110.0 * i / kSampleRate));
+        sine.setSample(0, i, value);
+        sine.setSample(1, i, value);
+    }
+
+    std::printf("Grain size and budget changes: 110 Hz sine (peak second difference %.5f), 4 grains, %.0f Hz\n\n",
+                peakSecondDifference(sine, 0, numSamples), kSampleRate);
+    std::printf("%-34s %10s %10s\n", "change", "before", "after");
+    for (const auto& change : kChanges) {
+        auto shifter = std::make_unique<GranularPitchShifter>();
+        prepareEngine(*shifter);
+        shifter->setGrainCount(4);
+        shifter->setOctaveMode(1);
+        shifter->setEngage(change.engaged);
+        juce::AudioBuffer<float> output(sine);
+        for (int pos = 0; pos + kBlockSize <= numSamples; pos += kBlockSize) {
+            if (pos == changeAt)
+                change.apply(*shifter);
+            shifter->processStereo(output.getWritePointer(0, pos), output.getWritePointer(1, pos), kBlockSize);
+        }
+        std::printf("%-34s %10.5f %10.5f\n", change.name, peakSecondDifference(output, changeAt - window, changeAt),
+                    peakSecondDifference(output, changeAt, changeAt + window));
+    }
+    return 0;
+}
+
+// Skewness of the first difference: a sawtooth's rare steep falls make it
+// negative, the same sawtooth played backward has steep rises instead
+double differenceSkew(const juce::AudioBuffer<float>& buffer, double sampleRate) {
+    std::vector<double> diffs;
+    for (int i = static_cast<int>(sampleRate * kSettleSeconds) + 1; i < buffer.getNumSamples(); ++i)
+        diffs.push_back(static_cast<double>(buffer.getSample(0, i)) - buffer.getSample(0, i - 1));
+    double mean = 0.0, m2 = 0.0, m3 = 0.0;
+    for (const double d : diffs)
+        mean += d / static_cast<double>(diffs.size());
+    for (const double d : diffs) {
+        m2 += juce::square(d - mean) / static_cast<double>(diffs.size());
+        m3 += std::pow(d - mean, 3.0) / static_cast<double>(diffs.size());
+    }
+    return m3 / std::pow(juce::jmax(m2, 1.0e-30), 1.5);
+}
+
+// Reverse grains, 4 grains at 0 OCT: forward output must not change when
+// Reverse has been toggled, a sawtooth must come out backward, and Reverse
+// with Freeze must keep playing the loop once the input stops
+int benchReverse() {
+    const int numSamples = static_cast<int>(kSampleRate * kSeconds);
+    juce::AudioBuffer<float> saw(2, numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        const double phase = 100.0 * i / kSampleRate;
+        const float value = static_cast<float>(0.5 * (phase - std::floor(phase)) - 0.25);
+        saw.setSample(0, i, value);
+        saw.setSample(1, i, value);
+    }
+    auto render = [&saw](bool reverse, bool toggled) {
+        return renderEngine<GranularPitchShifter>([reverse, toggled](GranularPitchShifter& shifter) {
+            shifter.setGrainCount(4);
+            shifter.setOctaveMode(2);
+            if (toggled)
+                shifter.setReverse(!reverse);
+            shifter.setReverse(reverse);
+        }, saw);
+    };
+    const auto forward = render(false, false);
+    const auto reverse = render(true, false);
+    std::printf("Reverse: 4 grains, 0 OCT, %.0f Hz\n\n", kSampleRate);
+    std::printf("forward after toggling Reverse, against untouched: %.1f dB\n",
+                nullDepthDb(render(false, true), forward, kSampleRate));
+    std::printf("100 Hz sawtooth, difference skew: forward %.2f, reverse %.2f\n",
+                differenceSkew(forward.output, kSampleRate), differenceSkew(reverse.output, kSampleRate));
+
+    // One second of the tone, then Reverse + Freeze over two seconds of silence
+    const auto tone = makeSustainedTone(kSampleRate, 1.0);
+    auto shifter = std::make_unique<GranularPitchShifter>();
+    prepareEngine(*shifter);
+    shifter->setGrainCount(4);
+    shifter->setReverse(true);
+    juce::AudioBuffer<float> live(tone);
+    for (int pos = 0; pos + kBlockSize <= live.getNumSamples(); pos += kBlockSize)
+        shifter->processStereo(live.getWritePointer(0, pos), live.getWritePointer(1, pos), kBlockSize);
+    shifter->setFreeze(true);
+    if (shifter->isCaptureRequested())
+        shifter->prepareCapture();
+    juce::AudioBuffer<float> frozen(2, static_cast<int>(kSampleRate * 2.0));
+    frozen.clear();
+    for (int pos = 0; pos + kBlockSize <= frozen.getNumSamples(); pos += kBlockSize)
+        shifter->processStereo(frozen.getWritePointer(0, pos), frozen.getWritePointer(1, pos), kBlockSize);
+    std::printf("Reverse + Freeze: RMS %.3f live, %.3f after 2 s of silence\n",
+                rmsAfterSettle(live, kSampleRate), rmsAfterSettle(frozen, kSampleRate));
+    return 0;
+}
+
+// Vector kernels against the Scalar table on every ISA this CPU runs, over
+// lengths that exercise the scalar tails. Tolerances: 1e-6 for the
+// element-wise kernels (the vector tanh is within ~6e-7 of std::tanh),
+// 1e-5 of sum |a[i] * b[i]| for dotProduct, whose lanes sum in another order.
+// Exits with 1 on any mismatch
+int benchSimd() {
+    static constexpr std::array<int, 5> kLengths { 1, 7, 64, 509, 4099 };
+    static constexpr std::array<const char*, 4> kKernels { "mixDryWet", "applyGainRamp", "softClip", "dotProduct" };
+    static constexpr std::array<double, 4> kTolerances { 1.0e-6, 1.0e-6, 1.0e-6, 1.0e-5 };
+    const auto best = SimdKernels::getBestSupportedIsa();
+    const auto& scalar = SimdKernels::getTable(SimdKernels::Isa::Scalar);
+
+    juce::Random random(1);
+    auto makeData = [&random](int length, float range) {
+        std::vector<float> data(static_cast<size_t>(length));
+        for (auto& x : data)
+            x = (random.nextFloat() * 2.0f - 1.0f) * range;
+        return data;
+    };
+
+    std::printf("SIMD kernels against Scalar: largest difference over %zu lengths up to %d samples\n\n",
+                kLengths.size(), kLengths.back());
+    std::printf("%-9s", "isa");
+    for (const char* kernel : kKernels)
+        std::printf(" %14s", kernel);
+    std::printf("\n%-9s", "tolerance");
+    for (const double tolerance : kTolerances)
+        std::printf(" %14.0e", tolerance);
+    std::printf("\n");
+    if (best == SimdKernels::Isa::Scalar) {
+        std::printf("no vector ISA on this CPU\n");
+        return 0;
+    }
+
+    bool failed = false;
+    for (int isa = static_cast<int>(SimdKernels::Isa::SSE2); isa <= static_cast<int>(best); ++isa) {
+        const auto& table = SimdKernels::getTable(static_cast<SimdKernels::Isa>(isa));
+        std::array<double, 4> errors {};
+        for (const int length : kLengths) {
+            const auto dry = makeData(length, 1.0f);
+            const auto wet = makeData(length, 1.0f);
+            const auto mix = makeData(length, 0.5f);
+            const auto gain = makeData(length, 2.0f);
+            auto maxDifference = [](const std::vector<float>& a, const std::vector<float>& b) {
+                double difference = 0.0;
+                for (size_t i = 0; i < a.size(); ++i)
+                    difference = juce::jmax(difference, std::abs(static_cast<double>(a[i]) - b[i]));
+                return difference;
+            };
+
+            auto reference = wet, vector = wet;
+            scalar.mixDryWet(reference.data(), dry.data(), mix.data(), gain.data(), length);
+            table.mixDryWet(vector.data(), dry.data(), mix.data(), gain.data(), length);
+            errors[0] = juce::jmax(errors[0], maxDifference(reference, vector));
+
+            reference = wet, vector = wet;
+            scalar.applyGainRamp(reference.data(), gain.data(), length);
+            table.applyGainRamp(vector.data(), gain.data(), length);
+            errors[1] = juce::jmax(errors[1], maxDifference(reference, vector));
+
+            reference = wet, vector = wet;
+            scalar.softClip(reference.data(), 4.0f, 1.0f, length);  // Drives up to +-4, deep into the clip
+            table.softClip(vector.data(), 4.0f, 1.0f, length);
+            errors[2] = juce::jmax(errors[2], maxDifference(reference, vector));
+
+            double magnitude = 0.0;
+            for (size_t i = 0; i < dry.size(); ++i)
+                magnitude += std::abs(static_cast<double>(dry[i]) * wet[i]);
+            const double dot = std::abs(static_cast<double>(scalar.dotProduct(dry.data(), wet.data(), length))
+                                        - table.dotProduct(dry.data(), wet.data(), length));
+            errors[3] = juce::jmax(errors[3], dot / juce::jmax(magnitude, 1.0e-30));
+        }
+
+        std::printf("%-9s", SimdKernels::getIsaName(static_cast<SimdKernels::Isa>(isa)));
+        for (size_t k = 0; k < errors.size(); ++k) {
+            const bool pass = errors[k] <= kTolerances[k];
+            failed = failed || !pass;
+            std::printf(" %9.1e %-4s", errors[k], pass ? "ok" : "FAIL");
+        }
+        std::printf("\n");
+    }
+    return failed ? 1 : 0;
+}
+
+struct Measurement {
+    const char* name;
+    const char* description;
+    int (*run)();
+};
+
+const Measurement kMeasurements[] {
+    { "tiers", "ECO/NORMAL/HQ: CPU per sample and null depth against HQ", benchTiers },
+    { "rates", "48k Internal off/on at 44.1-192 kHz host rates: CPU and latency", benchRates },
+    { "granular", "Granular engine alone per octave and interpolation, and per grain count: CPU", benchGranular },
+    { "stereo", "Planar against interleaved delay line: grain tap CPU, engine estimate", benchStereo },
+    { "splice", "FIXED/WSOLA/PSOLA on a sustained tone: CPU, cost per restart, output RMS", benchSplice },
+    { "formant", "SPECTRAL vowel shift, formant off/on: envelope deviation of the harmonics", benchFormant },
+    { "engines", "ANALOG, GRANULAR and SPECTRAL (+ Formant) at +1 OCT: relative CPU", benchEngines },
+    { "onset", "Onset Sync off/on on struck bursts: attack timing, extra copies", benchOnset },
+    { "cloud", "Cloud at densities 8-64 against 2 grains: CPU, grains playing", benchCloud },
+    { "reverse", "Reverse: forward bit-identity, backward playback, Reverse + Freeze", benchReverse },
+    { "budget", "Grain size and latency budget changes on a sine: click check", benchBudget },
+    { "simd", "SSE2/AVX2/AVX-512 kernels against Scalar; exits with 1 on a mismatch", benchSimd },
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    if (argc > 1) {
+        for (const auto& measurement : kMeasurements)
+            if (std::strcmp(argv[1], measurement.name) == 0)
+                return measurement.run();
+    }
+
+    std::printf("Usage: SwarmnessBench <measurement>\n\n");
+    for (const auto& measurement : kMeasurements)
+        std::printf("  %-10s %s\n", measurement.name, measurement.description);
+    return 1;
+}
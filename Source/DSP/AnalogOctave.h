@@ -0,0 +1,174 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+
+/**
+ * AnalogOctave - Eco pitch engine modelled on analog octave pedals, a few
+ * operations per sample and no latency.
+ *
+ * Down (-1/-2 oct): the input is low-passed towards its fundamental and a
+ * Schmitt trigger (hysteresis tracks the signal level) clocks a flip-flop on
+ * every rising zero crossing; a second flip-flop divides once more for -2.
+ * The flip-flop flips the polarity of the filtered input, so the sub octave
+ * keeps the note's envelope, as in the classic ring-switch circuits.
+ * Up (+1/+2 oct): full-wave rectification doubles the fundamental; the DC
+ * it leaves is removed and the result rectified again for +2.
+ * Both are smoothed by a one-pole low-pass. Glide and pitch modulation
+ * don't apply: the divider only knows whole octaves, so an octave change
+ * crossfades from the old mode to the new one instead.
+ */
+class AnalogOctave
+{
+public:
+    static constexpr double kTrackingHz = 500.0;    // Pre-filter before the divider
+    static constexpr double kToneHz = 3000.0;       // Output smoothing
+    static constexpr double kDcHz = 20.0;           // Rectifier DC removal
+    static constexpr float kHysteresis = 0.15f;     // Of the tracked level
+    static constexpr float kGateFloor = 1.0e-3f;    // No flips in the noise floor
+    static constexpr float kRectifierGain = 2.3f;   // |sin| keeps ~0.43 of the RMS
+
+    void prepare(double sampleRate)
+    {
+        auto onePole = [sampleRate](double hz)
+        {
+            return static_cast<float>(1.0 - std::exp(-2.0 * juce::MathConstants<double>::pi * hz / sampleRate));
+        };
+        trackingCoeff = onePole(kTrackingHz);
+        toneCoeff = onePole(kToneHz);
+        dcCoeff = onePole(kDcHz);
+        levelCoeff = onePole(10.0);
+        wetGain.reset(sampleRate, 0.02);  // 20ms, same engage fade as the shifters
+        wetGain.setCurrentAndTargetValue(isEngaged ? 1.0f : 0.0f);
+        modeFade.reset(sampleRate, 0.02);
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& channel : channels)
+            channel = Channel {};
+        modeFade.setCurrentAndTargetValue(1.0f);
+        running = false;
+    }
+
+    // 0=-2oct, 1=-1oct, 2=0oct, 3=+1oct, 4=+2oct
+    void setOctaveMode(int mode)
+    {
+        const int next = juce::jlimit(0, 4, mode) - 2;
+        if (next == octave)
+            return;
+        if (!running)
+        {
+            octave = next;  // Nothing playing yet to fade from
+            return;
+        }
+        if (octave == 0)
+        {
+            for (auto& channel : channels)
+                channel.tone = 0.0f;  // Not run while unshifted
+        }
+        previousOctave = octave;
+        octave = next;
+        modeFade.setCurrentAndTargetValue(0.0f);
+        modeFade.setTargetValue(1.0f);
+    }
+
+    void setEngage(bool engaged)
+    {
+        isEngaged = engaged;
+        wetGain.setTargetValue(engaged ? 1.0f : 0.0f);
+    }
+
+    void processStereo(float* leftChannel, float* rightChannel, int numSamples)
+    {
+        running = true;
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            const float wet = wetGain.getNextValue();
+            const float fade = modeFade.getNextValue();
+            const float dryL = leftChannel[sample];
+            const float dryR = rightChannel[sample];
+            leftChannel[sample] = dryL + (processSample(channels[0], dryL, fade) - dryL) * wet;
+            rightChannel[sample] = dryR + (processSample(channels[1], dryR, fade) - dryR) * wet;
+        }
+    }
+
+private:
+    struct Channel
+    {
+        float tracked = 0.0f;     // Pre-filtered input
+        float level = 0.0f;       // Rectified, smoothed tracked level
+        float tone = 0.0f;        // Output low-pass
+        float dc1 = 0.0f;         // Rectifier DC estimates
+        float dc2 = 0.0f;
+        float flip1 = 1.0f;       // Divider outputs, +-1
+        float flip2 = 1.0f;
+        bool high = false;        // Schmitt trigger state
+    };
+
+    // fade: share of the current mode, the rest is previousOctave's output
+    float processSample(Channel& c, float x, float fade)
+    {
+        const float from = 1.0f - fade;
+        if (octave == 0 && (from <= 0.0f || previousOctave == 0))
+            return x;
+
+        std::array<float, 5> y { 0.0f, 0.0f, x, 0.0f, 0.0f };  // Per octave, -2 to +2
+        if (octave < 0 || (from > 0.0f && previousOctave < 0))
+        {
+            c.tracked += trackingCoeff * (x - c.tracked);
+            c.level += levelCoeff * (std::abs(c.tracked) - c.level);
+            const float threshold = kHysteresis * c.level + kGateFloor;
+            if (!c.high && c.tracked > threshold)
+            {
+                c.high = true;
+                c.flip1 = -c.flip1;
+                if (c.flip1 > 0.0f)
+                    c.flip2 = -c.flip2;
+            }
+            else if (c.high && c.tracked < -threshold)
+                c.high = false;
+            y[0] = c.tracked * c.flip2;
+            y[1] = c.tracked * c.flip1;
+        }
+        if (octave > 0 || (from > 0.0f && previousOctave > 0))
+        {
+            float up = std::abs(x);
+            c.dc1 += dcCoeff * (up - c.dc1);
+            up -= c.dc1;
+            y[3] = up * kRectifierGain;
+            up = std::abs(up);
+            c.dc2 += dcCoeff * (up - c.dc2);
+            up -= c.dc2;
+            y[4] = up * kRectifierGain * kRectifierGain;
+        }
+
+        // Shifted modes share the tone filter, unshifted input bypasses it
+        float shifted = 0.0f;
+        float unshifted = 0.0f;
+        auto add = [&](int mode, float weight)
+        {
+            (mode == 0 ? unshifted : shifted) += weight * y[static_cast<size_t>(mode + 2)];
+        };
+        add(octave, fade);
+        if (from > 0.0f)
+            add(previousOctave, from);
+
+        c.tone += toneCoeff * (shifted - c.tone);
+        return c.tone + unshifted;
+    }
+
+    std::array<Channel, 2> channels {};
+    int octave = 1;
+    int previousOctave = 1;       // Fading out after an octave change
+    bool running = false;         // Processed audio since reset()
+    bool isEngaged = true;
+    float trackingCoeff = 0.07f;
+    float toneCoeff = 0.35f;
+    float dcCoeff = 0.003f;
+    float levelCoeff = 0.0014f;
+    juce::SmoothedValue<float> wetGain{1.0f};
+    juce::SmoothedValue<float> modeFade{1.0f};  // 0 to 1 after an octave change
+};
@@ -41,6 +41,14 @@ void ChorusEngine::setFeedback(float fb) {
     mFeedback = juce::jlimit(0.0f, 0.9f, fb);
 }
 
+void ChorusEngine::setQuality(ProcessingQuality quality) {
+    mQuality = quality;
+}
+
+void ChorusEngine::setSincInterpolation(bool enabled) {
+    mSincInterpolation = enabled;
+}
+
 // v1.2.8: Fast linear interpolation for Classic mode
 float ChorusEngine::linearInterpolate(const std::vector<float>& buffer, float pos) {
     int size = static_cast<int>(buffer.size());
@@ -77,6 +85,22 @@ float ChorusEngine::hermiteInterpolate(const std::vector<float>& buffer, float p
     return ((c3 * frac + c2) * frac + c1) * frac + c0;
 }
 
+// Band-limited read: taps are contiguous except across the ring wrap
+float ChorusEngine::sincInterpolate(const std::vector<float>& buffer, float pos) {
+    int size = static_cast<int>(buffer.size());
+    int x0 = static_cast<int>(pos);
+    float frac = pos - x0;
+    int first = x0 - SincTable::kTapsBefore;
+
+    if (first >= 0 && first + SincTable::kTaps <= size)
+        return SincTable::interpolate(buffer.data() + first, frac);
+
+    std::array<float, SincTable::kTaps> taps;
+    for (int i = 0; i < SincTable::kTaps; ++i)
+        taps[static_cast<size_t>(i)] = buffer[static_cast<size_t>((((first + i) % size) + size) % size)];
+    return SincTable::interpolate(taps.data(), frac);
+}
+
 void ChorusEngine::process(juce::AudioBuffer<float>& buffer) {
     const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
@@ -96,6 +120,12 @@ void ChorusEngine::process(juce::AudioBuffer<float>& buffer) {
         useHermite = false;  // v1.2.8: Use fast linear interpolation for Classic
     }
 
+    // Quality tier overrides the per-mode interpolation choice
+    if (mQuality == ProcessingQuality::Eco)
+        useHermite = false;
+    else if (mQuality == ProcessingQuality::HQ)
+        useHermite = true;
+
     const float baseDelaySamples = baseDelay * 0.001f * static_cast<float>(mSampleRate);
     const float modDepthSamples = modDepth * 0.001f * static_cast<float>(mSampleRate) * mDepth;
     
@@ -133,9 +163,11 @@ void ChorusEngine::process(juce::AudioBuffer<float>& buffer) {
                 if (readPos < 0) readPos += kMaxDelayLength;
 
                 // v1.2.8: Use linear interpolation for Classic, hermite for Deep
-                float delaySample = useHermite 
-                    ? hermiteInterpolate(mDelayBuffer[ch], readPos)
-                    : linearInterpolate(mDelayBuffer[ch], readPos);
+                float delaySample = mSincInterpolation
+                    ? sincInterpolate(mDelayBuffer[ch], readPos)
+                    : useHermite
+                        ? hermiteInterpolate(mDelayBuffer[ch], readPos)
+                        : linearInterpolate(mDelayBuffer[ch], readPos);
                 chorusOut += delaySample;
 
                 // Advance LFO phase
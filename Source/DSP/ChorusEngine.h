@@ -2,6 +2,8 @@
 #include <JuceHeader.h>
 #include <array>
 #include <vector>
+#include "ProcessingQuality.h"
+#include "SincTable.h"
 
 /**
  * ChorusEngine - Stereo chorus with Classic and Deep modes
@@ -32,6 +34,8 @@ public:
     void setDepth(float depth);  // 0-1
     void setMix(float mix);      // 0-1
     void setFeedback(float fb);  // 0-1
+    void setQuality(ProcessingQuality quality);
+    void setSincInterpolation(bool enabled);  // Band-limited reads, overrides the tier
     void process(juce::AudioBuffer<float>& buffer);
 
 private:
@@ -42,6 +46,8 @@ private:
     float linearInterpolate(const std::vector<float>& buffer, float pos);
     // Hermite kept for Deep mode (better quality)
     float hermiteInterpolate(const std::vector<float>& buffer, float pos);
+    // 8-tap polyphase sinc from the shared SincTable
+    float sincInterpolate(const std::vector<float>& buffer, float pos);
     
     // v1.2.8: Fast sin using LUT
     inline float fastSin(float phase) const {
@@ -60,6 +66,8 @@ private:
     float mDepth = 0.5f;
     float mMix = 0.0f;
     float mFeedback = 0.0f;
+    ProcessingQuality mQuality = ProcessingQuality::Normal;
+    bool mSincInterpolation = false;
 
     std::array<std::vector<float>, 2> mDelayBuffer;
     int mWritePos = 0;
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cmath>
+
+/**
+ * FastMath - Cheap approximations for control-rate pitch math.
+ * exp2: exact exponent + degree-5 polynomial for the fraction, relative
+ * error below 3e-7 (under 0.0005 cents when used for pitch ratios).
+ * The polynomial is written as 1 + f * q(f), so values near 2^0 stay
+ * accurate to the precision of FloatType.
+ */
+namespace FastMath
+{
+    template <typename FloatType>
+    inline FloatType fastExp2(FloatType x)
+    {
+        const FloatType xi = std::floor(x);
+        const FloatType f = x - xi;
+        const FloatType q = (((FloatType(0.0017883687) * f + FloatType(0.0091993876)) * f
+                              + FloatType(0.0556570544)) * f + FloatType(0.2402071942)) * f
+                              + FloatType(0.6931475676);
+        return std::ldexp(FloatType(1) + f * q, static_cast<int>(xi));
+    }
+}
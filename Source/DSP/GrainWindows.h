@@ -0,0 +1,92 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+
+/**
+ * GrainWindows - Shared read-only grain window shapes. One kSize-point
+ * table per shape for the whole plugin, built at load time; grains of any
+ * length and sample rate read them through their Q16 window phase with
+ * linear interpolation, so the memory is fixed (64 KB) however many
+ * instances, rates and grain sizes are in use.
+ *
+ * Tables are periodic (entry 0 is the closed edge, the peak is at kSize/2)
+ * with one extra entry equal to entry 0, so interpolation never wraps.
+ * Tukey and trapezoid taper over a quarter window each side and are flat in
+ * between; with 4 or 8 grains spaced G/N apart every shape sums to a
+ * constant (getMean() x N), with 2 grains only Hann does.
+ */
+class GrainWindows
+{
+public:
+    enum class Shape
+    {
+        Hann = 0,
+        Tukey,       // Raised-cosine tapers, flat middle half
+        Trapezoid,   // Linear tapers, flat middle half
+        Blackman     // Lowest sidelobes, narrowest
+    };
+    static constexpr int kNumShapes = 4;
+    static constexpr int kSize = 4096;
+
+    static const float* get(Shape shape) noexcept
+    {
+        return tables.data() + static_cast<int>(shape) * (kSize + 1);
+    }
+
+    // Average window value, i.e. the overlap-add sum per grain
+    static float getMean(Shape shape) noexcept
+    {
+        static constexpr std::array<float, kNumShapes> kMeans { 0.5f, 0.75f, 0.75f, 0.42f };
+        return kMeans[static_cast<size_t>(shape)];
+    }
+
+    // position in table entries, 0 to kSize
+    static float lookup(const float* table, float position) noexcept
+    {
+        const int index = juce::jmin(kSize - 1, static_cast<int>(position));
+        const float frac = position - static_cast<float>(index);
+        return table[index] + frac * (table[index + 1] - table[index]);
+    }
+
+private:
+    using Table = std::array<float, kNumShapes * (kSize + 1)>;
+
+    static Table build()
+    {
+        const double pi = juce::MathConstants<double>::pi;
+        constexpr int kTaper = kSize / 4;
+
+        Table t{};
+        for (int s = 0; s < kNumShapes; ++s)
+        {
+            float* w = t.data() + s * (kSize + 1);
+            for (int i = 0; i <= kSize; ++i)
+            {
+                const int edge = juce::jmin(i % kSize, kSize - i % kSize);  // Distance from the closed edge
+                const double x = static_cast<double>(i) / kSize;
+                double value = 0.0;
+                switch (static_cast<Shape>(s))
+                {
+                    case Shape::Hann:
+                        value = 0.5 * (1.0 - std::cos(2.0 * pi * x));
+                        break;
+                    case Shape::Tukey:
+                        value = edge < kTaper ? 0.5 * (1.0 - std::cos(pi * edge / kTaper)) : 1.0;
+                        break;
+                    case Shape::Trapezoid:
+                        value = edge < kTaper ? static_cast<double>(edge) / kTaper : 1.0;
+                        break;
+                    case Shape::Blackman:
+                        value = 0.42 - 0.5 * std::cos(2.0 * pi * x) + 0.08 * std::cos(4.0 * pi * x);
+                        break;
+                }
+                w[i] = static_cast<float>(juce::jmax(0.0, value));
+            }
+        }
+        return t;
+    }
+
+    alignas(64) static inline const Table tables = build();
+};
@@ -1,48 +1,140 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <array>
+#include <atomic>
 #include <vector>
 #include <cmath>
+#include "ProcessingQuality.h"
+#include "FastMath.h"
+#include "SimdKernels.h"
+#include "PeriodDetector.h"
+#include "OnsetDetector.h"
+#include "SincTable.h"
+#include "GrainWindows.h"
 
 /**
  * GranularPitchShifter - Based on original Noise Glitch algorithm
- * Uses 2 overlapping grains with Hann windowing for smooth pitch shifting.
+ * Uses 2, 4 or 8 overlapping grains with Hann windowing for smooth pitch
+ * shifting (2 grains = original 50% overlap). Grain state is kept as
+ * struct-of-arrays so the per-grain loops run across all grains at once.
+ * The delay line is stored interleaved (L R L R ...), so every grain tap
+ * loads and interpolates both channels together in one SIMD pair; linear
+ * and Hermite reads fill a 4-lane vector with two grains' frames.
+ * WSOLA mode moves each grain restart to the splice point that best
+ * correlates with the grain it crossfades against. PSOLA mode sizes the
+ * grains to a whole number of detected periods and restarts them a whole
+ * number of periods behind the grain they crossfade against.
+ * Up to four voices (harmonizer) read their own grain sets from the one
+ * delay line, so each extra voice only costs its grain reads.
+ * Upward shifts are band-limited before the delay-line write so the faster
+ * grain reads don't alias; the dry tap reads the unfiltered input from a
+ * short ring of its own.
+ * Onset sync places grain restarts around each detected attack so it is
+ * read once, by one grain at its window peak, in time with the dry signal.
+ * The delay line holds a few seconds so Freeze can stop writing and keep
+ * the grains cycling through the captured audio.
+ * Reverse mode runs the grain reads backward through the same masked
+ * delay line, each grain playing its span last sample first.
+ * Cloud mode replaces the voices' fixed grain sets with a pool of up to
+ * kCloudGrains short grains spawned at random positions, pitches, pans and
+ * durations; the pool is kept packed so the per-grain passes only run over
+ * playing grains.
+ * Tape mode drops the grains for a single polyphase-sinc read head that
+ * moves at the pitch ratio, so pitch and time change together; the head
+ * splices back into reach with a short crossfade, and disengaging spins
+ * the tape down to a stop over the rise time.
+ * The grain size follows the lowest voice target: short grains (low
+ * latency) within an octave of unison, doubling per octave further down so
+ * -2 oct stays smooth, capped at half the latency budget. The latency is
+ * the budget itself, so size changes never move it: running grains carry
+ * on through their windows and only restarts take the new size.
+ * Grain windows (Hann, Tukey, trapezoid or Blackman) are read from the
+ * shared fixed-size GrainWindows tables through the Q16 grain phase; Cloud
+ * grains and the Tape splices always use Hann.
  * Supports -2, -1, 0, +1, +2 octave shifts with smooth glide.
  */
 class GranularPitchShifter
 {
 public:
+    // Mirrored frames past the end of the delay buffer (sinc reads 8 taps)
+    static constexpr int kGuardSamples = SincTable::kTaps - 1;
+    static constexpr int kMaxGrains = 8;
+    static constexpr int kMaxVoices = 4;
+    static constexpr int kCloudGrains = 64;
+    static constexpr double kCloudGrainSeconds = 0.04;    // Mean cloud grain length
+    static constexpr double kCloudScatterSeconds = 0.25;  // Position scatter at full spread
+    static constexpr double kTapeReachSeconds = 0.5;      // Tape: how far back a fast head splices to
+    static constexpr double kLiveSeconds = 1.0;     // Ring reach without capture: tape, cloud, grains, write-head margin
+    static constexpr double kCaptureSeconds = 2.0;  // Freeze loop length (at least), once Freeze has been used
+    static constexpr double kShortGrainMs = 10.0;   // Within an octave of unison
+    static constexpr int kMinGrainMs = 4;
+    static constexpr int kMaxGrainMs = 40;
+    static constexpr double kDryFadeSeconds = 0.02;  // Dry tap crossfade on a latency change
+    static constexpr double kMaxBudgetMs = 80.0;     // Longest latency budget, sizes the dry ring
+    // Grain phases are Q16 window positions so PSOLA can stretch the window
+    static constexpr int kPhaseBits = 16;
+    static constexpr int kPhaseOne = 1 << kPhaseBits;
+    
+    enum class GrainMode
+    {
+        Fixed = 0,  // Restart a fixed distance behind the write head (original)
+        Wsola,      // Restart at the best cross-correlation splice point
+        Psola       // Period-sized grains restarted in phase with the signal
+    };
+    
     GranularPitchShifter() = default;
     
     void prepare(double sampleRate, int maxBlockSize)
     {
         this->sampleRate = sampleRate;
+        kernels = &SimdKernels::select();
+        
+        // Buffer size: what the live grains, cloud and tape reach, or the
+        // freeze capture length once Freeze has been used, rounded up to a
+        // power of two so wrapping is a mask; guard samples mirror the start
+        // of the buffer so interpolator taps never need wrapping either
+        if (captureStaged.exchange(false))
+            captureEnabled.store(true);
+        captureBuffer = {};
+        bufferSize = getRingFrames(captureEnabled.load() ? kCaptureSeconds : kLiveSeconds);
+        bufferMask = bufferSize - 1;
+        delayBuffer.assign(static_cast<size_t>((bufferSize + kGuardSamples) * 2), 0.0f);
         
-        // Buffer size: ~100ms worth of samples
-        bufferSize = static_cast<int>(sampleRate * 0.1);
-        delayBufferL.resize(static_cast<size_t>(bufferSize), 0.0f);
-        delayBufferR.resize(static_cast<size_t>(bufferSize), 0.0f);
+        // Dry tap ring: unfiltered input, long enough for the largest budget.
+        // Also a power of two no longer than the delay line, so writePos indexes it
+        const int dryFrames = juce::nextPowerOfTwo(static_cast<int>(sampleRate * kMaxBudgetMs / 1000.0) + 1);
+        dryMask = dryFrames - 1;
+        dryBuffer.assign(static_cast<size_t>(dryFrames * 2), 0.0f);
         
-        // Grain size: ~15ms for smooth pitch shifting
-        grainSize = static_cast<int>(sampleRate * 0.015);
+        latencySamples = getBudgetSamples();
+        dryFadeLength = static_cast<int>(sampleRate * kDryFadeSeconds);
+        dryFade = 0;
+        grainMs = 0;
+        setGrainSize(chooseGrainMs());
         
         // Initialize grain positions
         writePos = 0;
-        readPos1 = 0.0;
-        readPos2 = static_cast<double>(grainSize / 2);  // 50% overlap
+        capturedFrames = 0;
+        frozen = false;
+        phaseStep = kPhaseOne;
+        grainPeriod = 0.0;
+        periodDetector.prepare(sampleRate);
+        onsetDetector.prepare(sampleRate);
+        onsetActive = false;
+        layoutGrains();
+        cloudLength = sampleRate * kCloudGrainSeconds;
+        cloudRandom.setSeed(1);  // Same cloud on every render
+        cloudActive = 0;
+        cloudCountdown = 0;
+        resetTape();
         
-        // Create Hann window for crossfading
-        window.resize(static_cast<size_t>(grainSize));
-        for (int i = 0; i < grainSize; ++i)
+        for (auto& voice : voices)
         {
-            window[static_cast<size_t>(i)] = 0.5f * (1.0f - std::cos(2.0f * juce::MathConstants<float>::pi * i / grainSize));
+            voice.currentLog2Ratio = 0.0;
+            voice.targetLog2Ratio = 0.0;
         }
-        
-        grainCounter1 = 0;
-        grainCounter2 = grainSize / 2;
-        
-        currentPitchRatio = 1.0;
-        targetPitchRatio = 1.0;
+        updateAntiAlias();
         
         // Glide smoothing coefficient (default 50ms rise time)
         updateGlideCoeff(50.0);
@@ -58,28 +150,38 @@ public:
         {
             double riseSamples = (riseTimeMs * sampleRate) / 1000.0;
             if (riseSamples < 1.0) riseSamples = 1.0;
-            glideCoeff = 1.0 - std::exp(-1.0 / riseSamples);
+            // Decay of the remaining glide distance is exp2(n * glideLog2Decay) after n samples
+            glideLog2Decay = -1.0 / (riseSamples * std::log(2.0));
+            // Tape stop/start: a linear speed ramp over the rise time
+            tapeSpeedStep = static_cast<float>(1.0 / riseSamples);
         }
     }
     
     void setOctaveMode(int mode)
     {
         // mode: 0=-2oct, 1=-1oct, 2=0oct, 3=+1oct, 4=+2oct
+        // Target kept in octaves (log2 of the ratio)
         switch (mode)
         {
-            case 0: targetPitchRatio = 0.25; break;  // -2 octaves
-            case 1: targetPitchRatio = 0.5; break;   // -1 octave
-            case 2: targetPitchRatio = 1.0; break;   // 0 (no shift)
-            case 3: targetPitchRatio = 2.0; break;   // +1 octave
-            case 4: targetPitchRatio = 4.0; break;   // +2 octaves
-            default: targetPitchRatio = 1.0;
+            case 0: voices[0].targetLog2Ratio = -2.0; break;  // -2 octaves
+            case 1: voices[0].targetLog2Ratio = -1.0; break;  // -1 octave
+            case 2: voices[0].targetLog2Ratio = 0.0; break;   // 0 (no shift)
+            case 3: voices[0].targetLog2Ratio = 1.0; break;   // +1 octave
+            case 4: voices[0].targetLog2Ratio = 2.0; break;   // +2 octaves
+            default: voices[0].targetLog2Ratio = 0.0;
         }
+        updateAntiAlias();
+        updateGrainSize();
     }
     
+    // In tape mode disengaging first spins the tape down, the wet fades out
+    // once it has stopped (see renderTape)
     void setEngage(bool engaged)
     {
         isEngaged = engaged;
-        wetGain.setTargetValue(engaged ? 1.0f : 0.0f);
+        if (engaged || !tapeEnabled)
+            wetGain.setTargetValue(engaged ? 1.0f : 0.0f);
+        updateAntiAlias();
     }
     
     void setRiseTime(float ms)
@@ -87,142 +189,1598 @@ public:
         updateGlideCoeff(ms);
     }
     
+    // Number of overlapping grains (2, 4 or 8). More overlap smooths large shifts.
+    void setGrainCount(int count)
+    {
+        const int n = count >= 8 ? 8 : (count >= 4 ? 4 : 2);
+        if (n == numGrains)
+            return;
+        numGrains = n;
+        layoutGrains();
+    }
+    
+    // Harmonizer: voice 0 follows the octave mode, voices 1-3 their own interval.
+    // Voices are summed at equal power.
+    void setVoiceCount(int count)
+    {
+        const int n = juce::jlimit(1, kMaxVoices, count);
+        if (n == numVoices)
+            return;
+        for (int v = numVoices; v < n; ++v)
+        {
+            voices[static_cast<size_t>(v)].currentLog2Ratio = voices[static_cast<size_t>(v)].targetLog2Ratio;
+            layoutVoice(v);
+        }
+        numVoices = n;
+        voiceGain = 1.0f / std::sqrt(static_cast<float>(n));
+        updateAntiAlias();
+        updateGrainSize();
+    }
+    
+    void setVoiceInterval(int voice, double semitones)
+    {
+        if (voice > 0 && voice < kMaxVoices)
+        {
+            voices[static_cast<size_t>(voice)].targetLog2Ratio = semitones / 12.0;
+            updateAntiAlias();
+            updateGrainSize();
+        }
+    }
+    
+    // Window of the voices' grains; the overlap gain follows the shape
+    void setWindowShape(GrainWindows::Shape shape)
+    {
+        if (shape == windowShape)
+            return;
+        windowShape = shape;
+        window = GrainWindows::get(windowShape);
+        grainGain = 1.0f / (static_cast<float>(numGrains) * GrainWindows::getMean(windowShape));
+    }
+    
+    // Latency in ms; the adaptive grain size uses up to half of it. Grains
+    // pick up the new delay as they restart, the dry tap crossfades to it
+    void setLatencyBudget(double ms)
+    {
+        ms = juce::jmin(ms, kMaxBudgetMs);
+        if (juce::approximatelyEqual(ms, latencyBudgetMs))
+            return;
+        latencyBudgetMs = ms;
+        if (grainMs > 0)  // Not before prepare()
+        {
+            dryFadeFrom = latencySamples;
+            dryFade = dryFadeLength;
+            latencySamples = getBudgetSamples();
+        }
+        updateGrainSize();
+    }
+    
+    // Eco/Normal: linear grain reads, HQ: 4-point Hermite
+    void setQuality(ProcessingQuality quality)
+    {
+        useHermite = (quality == ProcessingQuality::HQ);
+    }
+    
+    // Band-limited 8-tap polyphase sinc reads, overrides the tier's choice
+    void setSincInterpolation(bool enabled)
+    {
+        useSinc = enabled;
+    }
+    
+    void setGrainMode(GrainMode mode)
+    {
+        if (mode == grainMode)
+            return;
+        grainMode = mode;
+        phaseStep = kPhaseOne;
+        grainPeriod = 0.0;
+        periodDetector.reset();
+    }
+    
+    // Lookahead: grain restarts snap to transients found in the latency window
+    void setLookahead(bool enabled)
+    {
+        lookaheadEnabled = enabled;
+    }
+    
+    // Onset sync: grain restarts are placed around detected attacks instead
+    // of wherever the fixed cadence puts them
+    void setOnsetSync(bool enabled)
+    {
+        if (enabled && !onsetSyncEnabled)
+            onsetDetector.reset();
+        onsetSyncEnabled = enabled;
+        onsetActive = false;
+    }
+    
+    /**
+     * Freeze: stops writing and loops the grains over the captured audio
+     * (up to kCaptureSeconds, less if the plugin hasn't run that long).
+     * The first engage loops what the live ring holds (kLiveSeconds) and
+     * requests the capture ring, see prepareCapture().
+     * Running grains carry on where they are and only their restarts move
+     * into the loop, so engaging and releasing crossfade through the grain
+     * windows. Pitch changes still glide with the rise time.
+     */
+    void setFreeze(bool shouldFreeze)
+    {
+        if (shouldFreeze == frozen)
+            return;
+        frozen = shouldFreeze;
+        if (frozen)
+        {
+            captureRequested.store(true);
+            onsetActive = false;
+            // Keep clear of the oldest frames, the write head reaches them
+            // first after release while grains may still be reading the loop
+            freezeLength = juce::jmin(capturedFrames, bufferSize - 8 * grainSize);
+            freezeScan = juce::jmax(0, freezeLength - latencySamples);
+        }
+        else
+            updateGrainSize();  // Held while frozen
+    }
+    
+    bool isFrozen() const
+    {
+        return frozen;
+    }
+    
+    /**
+     * Freeze capture ring. Until Freeze is first engaged the ring is only as
+     * long as live playback needs; then isCaptureRequested() turns true and
+     * the owner calls prepareCapture() off the audio thread. The next
+     * processStereo() adopts the larger ring, keeping the recorded audio and
+     * every read position, and later prepares keep the capture size.
+     */
+    bool isCaptureRequested() const
+    {
+        return captureRequested.load() && !captureEnabled.load();
+    }
+    
+    // Stages the ring once: does nothing when a ring is already staged or adopted
+    void prepareCapture()
+    {
+        if (!isCaptureRequested() || captureStaged.load())
+            return;
+        const int frames = getRingFrames(kCaptureSeconds);
+        captureBuffer.assign(static_cast<size_t>((frames + kGuardSamples) * 2), 0.0f);
+        captureStaged.store(true);
+    }
+    
+    // Reverse: grains read backward with the same windows. Splice search,
+    // PSOLA placement and onset sync assume forward reads and are skipped.
+    // Switching restarts the grain layout (forward grains at reverse
+    // positions could overtake the write head)
+    void setReverse(bool enabled)
+    {
+        if (enabled == reverse)
+            return;
+        reverse = enabled;
+        layoutGrains();
+    }
+    
+    // Cloud: random short grains instead of the voices' grain sets. The
+    // voices' ratios still set the pitches (each grain picks one voice), so
+    // the octave, glide, harmonizer and Freeze/Reverse all carry over
+    void setCloud(bool enabled)
+    {
+        if (enabled == cloudEnabled)
+            return;
+        cloudEnabled = enabled;
+        cloudActive = 0;
+        cloudCountdown = 0;
+        if (!enabled)
+            layoutGrains();  // Voice grains sat still while the cloud played
+        updateAntiAlias();
+    }
+    
+    // Tape: one read head at voice 0's ratio instead of grains (takes
+    // precedence over Cloud, the other voices are silent)
+    void setTape(bool enabled)
+    {
+        if (enabled == tapeEnabled)
+            return;
+        tapeEnabled = enabled;
+        resetTape();
+        if (!enabled && !isEngaged)
+            wetGain.setTargetValue(0.0f);  // Released mid-stop
+        if (!enabled)
+            layoutGrains();
+        updateAntiAlias();
+        updateGrainSize();
+    }
+    
+    // Average number of overlapping cloud grains, 0-1 maps to 8-64
+    void setCloudDensity(float density)
+    {
+        cloudOverlap = 8.0f + 56.0f * juce::jlimit(0.0f, 1.0f, density);
+        cloudGain = 1.0f / std::sqrt(cloudOverlap * 0.375f);  // Uncorrelated Hann grains sum in power
+    }
+    
+    // Cloud grains playing right now
+    int getCloudGrainCount() const
+    {
+        return cloudActive;
+    }
+    
+    // Spread (0-1): position scatter and stereo width. Scatter (0-1): per-grain
+    // detune (up to +-1 octave) and length (half to double)
+    void setCloudSpread(float spread, float scatter)
+    {
+        cloudSpread = juce::jlimit(0.0f, 1.0f, spread);
+        scatter = juce::jlimit(0.0f, 1.0f, scatter);
+        if (!juce::approximatelyEqual(scatter, cloudScatter))
+        {
+            cloudScatter = scatter;
+            updateAntiAlias();
+        }
+    }
+    
+    // Delay of the wet (and internally blended dry) signal at unity ratio
+    int getLatencySamples() const
+    {
+        return latencySamples;
+    }
+    
     // Modulation input: adds detuning in semitones
     void setModulation(double modSemitones)
     {
         modulationOffset = modSemitones;
     }
     
+    // Sustained part of the modulation (MIDI note glide, bend, whammy) at its
+    // highest until the next call, in semitones; it rides on every voice, so
+    // the anti-alias cutoff follows it
+    void setHeldOffset(double semitones)
+    {
+        if (juce::approximatelyEqual(semitones, heldOffset))
+            return;
+        heldOffset = semitones;
+        updateAntiAlias();
+    }
+    
+    // Modulation is held for the whole call, so callers pass one control period
+    // (or the whole block when modulation is static)
     void processStereo(float* leftChannel, float* rightChannel, int numSamples)
     {
+        if (numSamples <= 0)
+            return;
+        if (captureStaged.load(std::memory_order_acquire))
+            adoptCapture();
+        
+        // Pitch ratio at control rate: the glide runs in the log2 domain, so
+        // across this call each voice's ratio is a geometric ramp rendered by
+        // a per-sample multiply
+        const double modLog2 = modulationOffset / 12.0;
+        std::array<double, kMaxVoices> voiceRatio;
+        std::array<double, kMaxVoices> ratioStep;
+        for (int v = 0; v < numVoices; ++v)
+        {
+            Voice& voice = voices[static_cast<size_t>(v)];
+            const double startLog2 = voice.currentLog2Ratio;
+            const double remaining = voice.currentLog2Ratio - voice.targetLog2Ratio;
+            if (std::abs(remaining) > 0.0)
+            {
+                voice.currentLog2Ratio = voice.targetLog2Ratio
+                                       + remaining * FastMath::fastExp2(glideLog2Decay * numSamples);
+                if (std::abs(voice.currentLog2Ratio - voice.targetLog2Ratio) < 1.0e-7)
+                    voice.currentLog2Ratio = voice.targetLog2Ratio;  // Within ~0.0001 cents: snap
+            }
+            ratioStep[static_cast<size_t>(v)] = FastMath::fastExp2((voice.currentLog2Ratio - startLog2) / numSamples);
+            voiceRatio[static_cast<size_t>(v)] = FastMath::fastExp2(startLog2 + modLog2);
+        }
+        
+        const bool pitchSynchronous = grainMode == GrainMode::Psola;
+        if (pitchSynchronous)
+            updatePitchSynchronousGrain();
+        const int windowEnd = grainSize << kPhaseBits;
+        
+        if (frozen)
+        {
+            // Nothing to write, detect or blend: the grains only read the loop
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                const float wet = wetGain.getNextValue();
+                float wetL, wetR;
+                renderWet(voiceRatio, ratioStep, windowEnd).store(wetL, wetR);
+                freezeScan = freezeScan + 1 < freezeLength ? freezeScan + 1 : 0;
+                leftChannel[sample] = wetL * wet;
+                rightChannel[sample] = wetR * wet;
+            }
+            return;
+        }
+        
         for (int sample = 0; sample < numSamples; ++sample)
         {
             float wet = wetGain.getNextValue();
             
-            // Smooth pitch ratio changes (glide/portamento)
-            currentPitchRatio += glideCoeff * (targetPitchRatio - currentPitchRatio);
-            
-            // Apply modulation offset to pitch ratio
-            double modulatedRatio = currentPitchRatio * std::pow(2.0, modulationOffset / 12.0);
-            
-            // Process left channel
-            float inputL = leftChannel[sample];
-            delayBufferL[static_cast<size_t>(writePos)] = inputL;
-            
-            float grain1L = readGrain(delayBufferL, readPos1, grainCounter1);
-            float grain2L = readGrain(delayBufferL, readPos2, grainCounter2);
-            float wetL = grain1L + grain2L;
-            
-            // Process right channel
-            float inputR = rightChannel[sample];
-            delayBufferR[static_cast<size_t>(writePos)] = inputR;
-            
-            float grain1R = readGrain(delayBufferR, readPos1, grainCounter1);
-            float grain2R = readGrain(delayBufferR, readPos2, grainCounter2);
-            float wetR = grain1R + grain2R;
-            
-            // Update read positions based on pitch ratio
-            double readIncrement = modulatedRatio;
+            // Write both channels (plus the mirrored guard copy near the start),
+            // band-limited first when a voice shifts up; the dry ring keeps
+            // the input as it came in
+            float inL = leftChannel[sample];
+            float inR = rightChannel[sample];
+            const int dryWrite = writePos & dryMask;
+            dryBuffer[static_cast<size_t>(dryWrite * 2)] = inL;
+            dryBuffer[static_cast<size_t>(dryWrite * 2 + 1)] = inR;
+            if (antiAliasActive)
+                applyAntiAlias(inL, inR);
+            writeFrame(inL, inR);
+            if (pitchSynchronous)
+                periodDetector.pushSample(leftChannel[sample] + rightChannel[sample]);
             
-            readPos1 += readIncrement;
-            readPos2 += readIncrement;
+            if (onsetSyncEnabled && onsetDetector.pushSample(leftChannel[sample] + rightChannel[sample]))
+                beginOnset();
             
-            // Wrap read positions
-            if (readPos1 >= bufferSize) readPos1 -= bufferSize;
-            if (readPos2 >= bufferSize) readPos2 -= bufferSize;
-            if (readPos1 < 0) readPos1 += bufferSize;
-            if (readPos2 < 0) readPos2 += bufferSize;
+            float wetL, wetR;
+            renderWet(voiceRatio, ratioStep, windowEnd).store(wetL, wetR);
             
-            // Update grain counters
-            grainCounter1++;
-            grainCounter2++;
-            
-            // Reset grains when they complete - resync to avoid drift
-            if (grainCounter1 >= grainSize)
-            {
-                grainCounter1 = 0;
-                readPos1 = static_cast<double>(writePos) - grainSize * 2;
-                if (readPos1 < 0) readPos1 += bufferSize;
-            }
-            
-            if (grainCounter2 >= grainSize)
+            // Dry signal delayed by the reported latency so engage fades stay
+            // aligned, crossfading from the previous delay after a change
+            const int dryPos = (writePos - latencySamples) & dryMask;
+            float dryL = dryBuffer[static_cast<size_t>(dryPos * 2)];
+            float dryR = dryBuffer[static_cast<size_t>(dryPos * 2 + 1)];
+            if (dryFade > 0)
             {
-                grainCounter2 = 0;
-                readPos2 = static_cast<double>(writePos) - grainSize * 2;
-                if (readPos2 < 0) readPos2 += bufferSize;
+                const int fromPos = (writePos - dryFadeFrom) & dryMask;
+                const float from = static_cast<float>(dryFade--) / static_cast<float>(dryFadeLength);
+                dryL += from * (dryBuffer[static_cast<size_t>(fromPos * 2)] - dryL);
+                dryR += from * (dryBuffer[static_cast<size_t>(fromPos * 2 + 1)] - dryR);
             }
             
-            writePos = (writePos + 1) % bufferSize;
+            writePos = (writePos + 1) & bufferMask;
+            if (capturedFrames < bufferSize)
+                ++capturedFrames;
             
             // Mix wet/dry based on engage state
-            leftChannel[sample] = inputL * (1.0f - wet) + wetL * wet;
-            rightChannel[sample] = inputR * (1.0f - wet) + wetR * wet;
+            leftChannel[sample] = dryL * (1.0f - wet) + wetL * wet;
+            rightChannel[sample] = dryR * (1.0f - wet) + wetR * wet;
         }
     }
     
     void reset()
     {
-        std::fill(delayBufferL.begin(), delayBufferL.end(), 0.0f);
-        std::fill(delayBufferR.begin(), delayBufferR.end(), 0.0f);
+        std::fill(delayBuffer.begin(), delayBuffer.end(), 0.0f);
+        std::fill(dryBuffer.begin(), dryBuffer.end(), 0.0f);
         writePos = 0;
-        readPos1 = 0.0;
-        readPos2 = static_cast<double>(grainSize / 2);
-        grainCounter1 = 0;
-        grainCounter2 = grainSize / 2;
-        currentPitchRatio = 1.0;
+        capturedFrames = 0;
+        frozen = false;
+        freezeLength = 0;
+        freezeScan = 0;
+        dryFade = 0;
+        periodDetector.reset();
+        onsetDetector.reset();
+        onsetActive = false;
+        grainPeriod = 0.0;
+        phaseStep = kPhaseOne;
+        layoutGrains();
+        cloudActive = 0;
+        cloudCountdown = 0;
+        resetTape();
+        for (auto& voice : voices)
+            voice.currentLog2Ratio = 0.0;
+        for (auto& stage : antiAliasStages)
+            stage.s1 = stage.s2 = StereoFrame::zero();
     }
     
 private:
-    float readGrain(std::vector<float>& buffer, double pos, int grainPhase)
+    // Per-voice grain set; all voices share the delay line, window and detector
+    struct Voice
     {
-        // Linear interpolation read from buffer
-        int intPos = static_cast<int>(pos);
-        double frac = pos - intPos;
+        alignas(64) std::array<double, kMaxGrains> grainReadPos {};
+        std::array<int, kMaxGrains> grainPhase {};   // Q16 window position of each grain
+        double currentLog2Ratio = 0.0;   // Octaves
+        double targetLog2Ratio = 0.0;
+        bool attackPlaced = false;       // Onset sync: this voice's attack grain has started
+    };
+    
+    // Cloud grain pool (SoA); grains 0..cloudActive-1 are playing
+    struct CloudGrains
+    {
+        alignas(64) std::array<double, kCloudGrains> readPos {};
+        alignas(64) std::array<float, kCloudGrains> detune {};   // Ratio relative to the grain's voice
+        alignas(64) std::array<float, kCloudGrains> gainL {};    // Pan x cloud gain
+        alignas(64) std::array<float, kCloudGrains> gainR {};
+        alignas(64) std::array<int, kCloudGrains> phase {};      // Q16 window position
+        alignas(64) std::array<int, kCloudGrains> phaseStep {};  // Q16 per sample, sets the length
+        alignas(64) std::array<int, kCloudGrains> voice {};
+    };
+    
+    int getRingFrames(double seconds) const
+    {
+        return juce::nextPowerOfTwo(static_cast<int>(sampleRate * seconds));
+    }
+    
+    // Swaps in the staged capture ring at a block boundary. Frames keep their
+    // age: the old ring's frames before writePos stay at the same index, the
+    // older ones from writePos on move up by the size difference, and so do
+    // the read positions among them. The old ring is freed by the next prepare.
+    void adoptCapture()
+    {
+        const int oldSize = bufferSize;
+        std::swap(delayBuffer, captureBuffer);
+        bufferSize = static_cast<int>(delayBuffer.size() / 2) - kGuardSamples;
+        bufferMask = bufferSize - 1;
+        const int shift = bufferSize - oldSize;
+        
+        const auto oldFrames = captureBuffer.begin();
+        std::copy(oldFrames, oldFrames + writePos * 2, delayBuffer.begin());
+        std::copy(oldFrames + writePos * 2, oldFrames + oldSize * 2, delayBuffer.begin() + (writePos + shift) * 2);
+        std::copy(delayBuffer.begin(), delayBuffer.begin() + kGuardSamples * 2, delayBuffer.begin() + bufferSize * 2);
+        
+        const double split = static_cast<double>(writePos);
+        auto move = [split, shift](double pos) { return pos >= split ? pos + shift : pos; };
+        for (auto& voice : voices)
+            for (auto& pos : voice.grainReadPos)
+                pos = move(pos);
+        for (size_t k = 0; k < static_cast<size_t>(cloudActive); ++k)
+            cloud.readPos[k] = move(cloud.readPos[k]);
+        tapePos = move(tapePos);
+        tapeFadePos = move(tapeFadePos);
+        if (onsetPos >= writePos)
+            onsetPos += shift;
         
-        int idx0 = intPos % bufferSize;
-        int idx1 = (intPos + 1) % bufferSize;
-        if (idx0 < 0) idx0 += bufferSize;
-        if (idx1 < 0) idx1 += bufferSize;
+        captureEnabled.store(true);
+        captureStaged.store(false);
+    }
+    
+    // Staggers the grains evenly across one grain length and sets the overlap
+    // gain: N windows spaced G/N apart sum to N times the window's mean
+    void layoutGrains()
+    {
+        for (int v = 0; v < kMaxVoices; ++v)
+            layoutVoice(v);
+        grainGain = 1.0f / (static_cast<float>(numGrains) * GrainWindows::getMean(windowShape));
+    }
+    
+    // 4th-order Butterworth low-pass at 0.9 x Nyquist / (highest upward
+    // ratio). Voice targets only: glide and modulation don't retune it, so
+    // coefficients change with the octave mode, intervals and engage state.
+    // Bypassed at or below unison and when disengaged, since the dry tap
+    // reads the same delay line.
+    void updateAntiAlias()
+    {
+        double maxLog2 = voices[0].targetLog2Ratio;
+        const int voicesInUse = tapeEnabled ? 1 : numVoices;
+        for (int v = 1; v < voicesInUse; ++v)
+            maxLog2 = std::max(maxLog2, voices[static_cast<size_t>(v)].targetLog2Ratio);
+        maxLog2 += heldOffset / 12.0;
+        if (cloudEnabled && !tapeEnabled)
+            maxLog2 += cloudScatter;  // Highest detuned cloud grain
+        
+        // A stopping tape still plays at up to the target ratio
+        if ((!isEngaged && !tapeEnabled) || maxLog2 <= 0.0)
+        {
+            antiAliasActive = false;
+            return;
+        }
+        if (antiAliasActive && juce::approximatelyEqual(maxLog2, antiAliasLog2))
+            return;
+        
+        const double cutoff = 0.9 * 0.5 * sampleRate / std::exp2(maxLog2);
+        const double w0 = 2.0 * juce::MathConstants<double>::pi * cutoff / sampleRate;
+        const double cosW0 = std::cos(w0);
+        static constexpr std::array<double, 2> kStageQ { 0.54119610, 1.30656296 };
+        for (size_t i = 0; i < antiAliasStages.size(); ++i)
+        {
+            auto& stage = antiAliasStages[i];
+            const double alpha = std::sin(w0) / (2.0 * kStageQ[i]);
+            const double a0 = 1.0 + alpha;
+            stage.b0 = static_cast<float>((1.0 - cosW0) * 0.5 / a0);
+            stage.b1 = static_cast<float>((1.0 - cosW0) / a0);
+            stage.b2 = stage.b0;
+            stage.a1 = static_cast<float>(-2.0 * cosW0 / a0);
+            stage.a2 = static_cast<float>((1.0 - alpha) / a0);
+            if (!antiAliasActive)
+                stage.s1 = stage.s2 = StereoFrame::zero();
+        }
+        antiAliasLog2 = maxLog2;
+        antiAliasActive = true;
+    }
+    
+    // Grain length for the voice targets: kShortGrainMs down to one octave
+    // below unison, doubled per octave below that (slower reads need longer
+    // grains to hold a period of the shifted signal), then capped so two
+    // grains fit the latency budget. Glide and modulation don't change it.
+    int chooseGrainMs() const
+    {
+        double minLog2 = 0.0;
+        const int voicesInUse = tapeEnabled ? 1 : numVoices;
+        for (int v = 0; v < voicesInUse; ++v)
+            minLog2 = std::min(minLog2, voices[static_cast<size_t>(v)].targetLog2Ratio);
+        const double ms = kShortGrainMs * std::exp2(std::max(0.0, -minLog2 - 1.0));
+        return juce::jlimit(kMinGrainMs, kMaxGrainMs,
+                            static_cast<int>(std::floor(std::min(ms, 0.5 * latencyBudgetMs))));
+    }
+    
+    // Block rate, from the setters that move the voice targets or the budget.
+    // Held while frozen: the loop and its running grains were sized for the
+    // current grain.
+    void updateGrainSize()
+    {
+        if (!frozen && grainMs > 0)  // Not before prepare()
+            setGrainSize(chooseGrainMs());
+    }
+    
+    // Rescales the window reads. Running grains keep their place in the
+    // window: voice and cloud phases (and cloud steps) and a tape splice
+    // scale with the size, so every grain plays out its window over the new
+    // length, the overlap sum holds and restarts take the new size. The
+    // latency is the budget's, so nothing restarts and the delay stays put.
+    void setGrainSize(int ms)
+    {
+        if (ms == grainMs)
+            return;
+        const int previousSize = grainSize;
+        grainMs = ms;
+        grainSize = static_cast<int>(sampleRate * ms / 1000.0);
+        windowScale = static_cast<float>(GrainWindows::kSize) / static_cast<float>(grainSize * kPhaseOne);
         
-        float sample = static_cast<float>(
-            buffer[static_cast<size_t>(idx0)] * (1.0 - frac) +
-            buffer[static_cast<size_t>(idx1)] * frac
-        );
+        auto rescale = [this, previousSize](int value)
+        {
+            return static_cast<int>(static_cast<juce::int64>(value) * grainSize / previousSize);
+        };
+        for (auto& voice : voices)
+            for (auto& phase : voice.grainPhase)
+                phase = rescale(phase);
+        for (size_t k = 0; k < static_cast<size_t>(cloudActive); ++k)
+        {
+            cloud.phase[k] = rescale(cloud.phase[k]);
+            cloud.phaseStep[k] = juce::jmax(1, rescale(cloud.phaseStep[k]));
+        }
+        tapeFade = rescale(tapeFade);
+    }
+    
+    // Latency budget in samples; at least two of the longest grains it allows
+    int getBudgetSamples() const
+    {
+        return static_cast<int>(sampleRate * latencyBudgetMs / 1000.0);
+    }
+    
+    // Voices are offset by a fraction of the grain spacing so their restarts
+    // (and WSOLA/PSOLA searches) fall on different samples
+    void layoutVoice(int v)
+    {
+        Voice& voice = voices[static_cast<size_t>(v)];
+        const int stagger = ((grainSize / numGrains) * v) / kMaxVoices;
+        const double start = getGrainStartPosition(voice);
+        for (int g = 0; g < kMaxGrains; ++g)
+        {
+            const int offset = (grainSize * g) / numGrains + stagger;
+            voice.grainPhase[static_cast<size_t>(g)] = g < numGrains ? offset << kPhaseBits : 0;
+            const double pos = reverse ? start - offset + bufferSize : start + offset;
+            voice.grainReadPos[static_cast<size_t>(g)] = std::fmod(pos, static_cast<double>(bufferSize));
+        }
+    }
+    
+    // Read position for a restarting grain: latencySamples behind the sample
+    // that will be written next, optionally moved onto a nearby transient or,
+    // in WSOLA/PSOLA mode, onto the best splice point (a found transient wins)
+    double getGrainStartPosition(const Voice& voice, int restartingGrain = -1, double ratio = 1.0) const
+    {
+        if (reverse)
+            return getReverseStartPosition(ratio);
+        if (frozen)
+            return getFrozenStartPosition(ratio);
         
-        // Apply window
-        if (grainPhase >= 0 && grainPhase < grainSize)
+        int start = writePos + 1 - latencySamples;
+        int offset = lookaheadEnabled ? findTransientOffset(start) : 0;
+        if (offset == 0 && restartingGrain >= 0)
         {
-            sample *= window[static_cast<size_t>(grainPhase)];
+            if (grainMode == GrainMode::Wsola)
+                offset = findSpliceOffset(voice, start, restartingGrain, ratio);
+            else if (grainMode == GrainMode::Psola && grainPeriod > 0.0)
+                return findPitchSynchronousStart(voice, start, restartingGrain);
         }
+        return static_cast<double>((start + offset) & bufferMask);
+    }
+    
+    // Freeze: restarts follow a scan position that advances in real time
+    // through the loop and wraps early enough that a grain's read span never
+    // runs past the (stopped) write head
+    double getFrozenStartPosition(double ratio) const
+    {
+        const double length = static_cast<double>(grainSize) * kPhaseOne / phaseStep;
+        const int span = static_cast<int>(std::ceil(ratio * length)) + kGuardSamples;
+        const int range = juce::jmax(1, freezeLength - span);
+        return static_cast<double>((writePos - freezeLength + freezeScan % range) & bufferMask);
+    }
+    
+    // Reverse: start where the forward grain's span would end and read back
+    // to its start, so the grain covers the same audio. Live, the start is
+    // kept a sinc kernel behind the write head; the frozen scan already
+    // keeps whole spans inside the loop
+    double getReverseStartPosition(double ratio) const
+    {
+        const double length = static_cast<double>(grainSize) * kPhaseOne / phaseStep;
+        const double size = static_cast<double>(bufferSize);
+        double pos;
+        if (frozen)
+            pos = getFrozenStartPosition(ratio) + ratio * length;
         else
+            pos = static_cast<double>(writePos + 1)
+                - juce::jmax(static_cast<double>(SincTable::kTaps), latencySamples - ratio * length);
+        return pos >= size ? pos - size : (pos < 0.0 ? pos + size : pos);
+    }
+    
+    // The attack lies somewhere in the hop that just ended; take its middle
+    void beginOnset()
+    {
+        onsetPos = (writePos - OnsetDetector::kHopSize / 2) & bufferMask;
+        onsetActive = true;
+        for (auto& voice : voices)
+            voice.attackPlaced = false;
+    }
+    
+    /**
+     * Onset sync: a grain whose read span would cut through the attack is
+     * moved so that it doesn't. Until the attack is due at the dry tap,
+     * restarts end their span just before it; then one grain per voice is
+     * started to read it at its window peak; later restarts begin at the
+     * attack, where their window is still closed. The attack is thus heard
+     * once, in time with the dry, instead of once per overlapping grain.
+     * Placements that would overtake the write head keep the nominal start.
+     */
+    double placeAroundOnset(Voice& voice, double nominal, double ratio)
+    {
+        const int next = writePos + 1;
+        const double size = static_cast<double>(bufferSize);
+        const double length = static_cast<double>(grainSize) * kPhaseOne / phaseStep;  // Window length in samples
+        const double onsetAge = static_cast<double>((next - onsetPos) & bufferMask);
+        if (onsetAge > latencySamples + length)
         {
-            sample = 0.0f;
+            onsetActive = false;  // Every nominal span now starts past the attack
+            return nominal;
         }
         
-        return sample;
+        double nominalAge = static_cast<double>(next) - nominal;
+        if (nominalAge <= 0.0)
+            nominalAge += size;
+        if (nominalAge <= onsetAge || nominalAge >= onsetAge + ratio * length)
+            return nominal;
+        
+        double age;
+        bool attackGrain = false;
+        if (voice.attackPlaced)
+            age = onsetAge;
+        else if (onsetAge + 0.5 * length / numGrains >= latencySamples - 0.5 * length)
+        {
+            age = onsetAge + ratio * 0.5 * length;
+            attackGrain = true;
+        }
+        else
+            age = onsetAge + ratio * length;
+        
+        const double minAge = 1.0 + juce::jmax(0.0, (ratio - 1.0) * length);
+        const double maxAge = size - kGuardSamples - 1.0 - juce::jmax(0.0, (1.0 - ratio) * length);
+        if (age < minAge || age > maxAge)
+            return nominal;
+        
+        voice.attackPlaced = voice.attackPlaced || attackGrain;
+        const double pos = static_cast<double>(next) - age;
+        return pos < 0.0 ? pos + size : pos;
     }
     
-    double sampleRate = 44100.0;
-    int bufferSize = 4410;
-    int grainSize = 661;
+    // The grain closest to its window peak, i.e. the one a restarting grain
+    // crossfades against (-1 if there is none)
+    int findReferenceGrain(const Voice& voice, int restartingGrain) const
+    {
+        int reference = -1;
+        int bestDistance = grainSize;
+        for (int g = 0; g < numGrains; ++g)
+        {
+            const int distance = std::abs((voice.grainPhase[static_cast<size_t>(g)] >> kPhaseBits) - grainSize / 2);
+            if (g != restartingGrain && distance < bestDistance)
+            {
+                bestDistance = distance;
+                reference = g;
+            }
+        }
+        return reference;
+    }
     
-    std::vector<float> delayBufferL;
-    std::vector<float> delayBufferR;
-    std::vector<float> window;
+    /**
+     * PSOLA: sizes grains to the whole number of detected periods closest to
+     * the fixed grain size (control rate, only when the detector has a new
+     * estimate). Periods longer than the window allows fall back to fixed grains.
+     */
+    void updatePitchSynchronousGrain()
+    {
+        if (!periodDetector.update())
+            return;
+        
+        grainPeriod = 0.0;
+        phaseStep = kPhaseOne;
+        const double coarse = periodDetector.getPeriod();
+        if (coarse <= 0.0)
+            return;
+        
+        const double period = refinePeriod(coarse);
+        const double length = std::max(1.0, std::round(grainSize / period)) * period;
+        if (length > 2.0 * grainSize)
+            return;
+        grainPeriod = period;
+        phaseStep = static_cast<int>(std::lround(kPhaseOne * grainSize / length));
+    }
     
-    int writePos = 0;
-    double readPos1 = 0.0;
-    double readPos2 = 0.0;
+    /**
+     * The detector works decimated; splices are a few dozen periods apart, so
+     * its error is taken out here. Normalised correlation of the newest frames
+     * against lags within one decimation step of the estimate, with a
+     * parabolic peak fit.
+     */
+    double refinePeriod(double coarse) const
+    {
+        constexpr int kMaxSpan = 32;
+        constexpr float kEnergyFloor = 1.0e-6f;
+        
+        const int span = juce::jmin(kMaxSpan, periodDetector.getDecimation());
+        const int length = juce::jmin(256, grainSize / 2);
+        const int newest = writePos - length;
+        const int centre = static_cast<int>(std::lround(coarse));
+        
+        std::array<float, 2 * kMaxSpan + 1> score {};
+        int best = -1;
+        for (int i = 0; i <= 2 * span; ++i)
+        {
+            const int lag = centre - span + i;
+            if (lag < 2)
+                continue;
+            const float c = correlate(newest, newest - lag, length);
+            const float e = correlate(newest - lag, newest - lag, length);
+            score[static_cast<size_t>(i)] = c / std::sqrt(e + kEnergyFloor);
+            if (best < 0 || score[static_cast<size_t>(i)] > score[static_cast<size_t>(best)])
+                best = i;
+        }
+        if (best < 0)
+            return coarse;
+        
+        double lag = centre - span + best;
+        if (best > 0 && best < 2 * span && centre - span + best - 1 >= 2)
+        {
+            const float a = score[static_cast<size_t>(best - 1)];
+            const float b = score[static_cast<size_t>(best)];
+            const float c = score[static_cast<size_t>(best + 1)];
+            const float denominator = a - 2.0f * b + c;
+            if (denominator < 0.0f)
+                lag += juce::jlimit(-0.5, 0.5, 0.5 * static_cast<double>(a - c) / static_cast<double>(denominator));
+        }
+        return lag;
+    }
     
-    int grainCounter1 = 0;
-    int grainCounter2 = 0;
+    // PSOLA restart: a whole number of periods behind the reference grain, at
+    // or just before the nominal start, so the crossfade joins in phase
+    double findPitchSynchronousStart(const Voice& voice, int nominalStart, int restartingGrain) const
+    {
+        const double size = static_cast<double>(bufferSize);
+        const int reference = findReferenceGrain(voice, restartingGrain);
+        if (reference < 0)
+            return static_cast<double>(nominalStart & bufferMask);
+        
+        const double referencePos = voice.grainReadPos[static_cast<size_t>(reference)];
+        double distance = referencePos - static_cast<double>(nominalStart & bufferMask);
+        if (distance > size * 0.5)
+            distance -= size;
+        else if (distance < -size * 0.5)
+            distance += size;
+        
+        double pos = referencePos - std::ceil(distance / grainPeriod) * grainPeriod;
+        pos = std::fmod(pos, size);
+        return pos < 0.0 ? pos + size : pos;
+    }
     
-    double currentPitchRatio = 1.0;
-    double targetPitchRatio = 1.0;
-    double glideCoeff = 0.001;
+    /**
+     * WSOLA: correlates the candidate start against what the most open other
+     * grain is about to read, over a quarter grain. Lags are searched
+     * every kCoarseStep samples across +-half a grain, then refined around
+     * the best one, so the cost is bounded per grain restart.
+     */
+    int findSpliceOffset(const Voice& voice, int nominalStart, int restartingGrain, double ratio) const
+    {
+        constexpr int kCoarseStep = 4;
+        constexpr float kEnergyFloor = 1.0e-6f;
+        
+        const int reference = findReferenceGrain(voice, restartingGrain);
+        if (reference < 0)
+            return 0;
+        
+        const int referencePos = static_cast<int>(voice.grainReadPos[static_cast<size_t>(reference)]);
+        const int length = grainSize / 4;
+        const int range = grainSize / 2;
+        
+        // The new grain must not overtake the write head during its lifetime
+        const int maxAhead = latencySamples - static_cast<int>(std::ceil(ratio * grainSize));
+        const int lo = -range;
+        const int hi = juce::jlimit(lo, range, maxAhead);
+        
+        auto score = [&](int offset)
+        {
+            const int candidate = nominalStart + offset;
+            const float c = correlate(referencePos, candidate, length);
+            const float e = correlate(candidate, candidate, length);
+            return c / std::sqrt(e + kEnergyFloor);
+        };
+        
+        int bestOffset = juce::jlimit(lo, hi, 0);
+        float bestScore = score(bestOffset);
+        for (int offset = lo; offset <= hi; offset += kCoarseStep)
+        {
+            const float value = score(offset);
+            if (value > bestScore)
+            {
+                bestScore = value;
+                bestOffset = offset;
+            }
+        }
+        
+        const int coarseBest = bestOffset;
+        for (int offset = juce::jmax(lo, coarseBest - kCoarseStep + 1);
+             offset <= juce::jmin(hi, coarseBest + kCoarseStep - 1); ++offset)
+        {
+            const float value = score(offset);
+            if (value > bestScore)
+            {
+                bestScore = value;
+                bestOffset = offset;
+            }
+        }
+        
+        return bestOffset;
+    }
+    
+    // Sum of L*L' + R*R' over numFrames interleaved frames, split at the ring end
+    float correlate(int posA, int posB, int numFrames) const
+    {
+        float sum = 0.0f;
+        posA &= bufferMask;
+        posB &= bufferMask;
+        while (numFrames > 0)
+        {
+            const int chunk = juce::jmin(numFrames, bufferSize - posA, bufferSize - posB);
+            sum += kernels->dotProduct(delayBuffer.data() + posA * 2, delayBuffer.data() + posB * 2, chunk * 2);
+            posA = (posA + chunk) & bufferMask;
+            posB = (posB + chunk) & bufferMask;
+            numFrames -= chunk;
+        }
+        return sum;
+    }
+    
+    /**
+     * Lookahead: scans half a grain either side of the nominal start for the
+     * strongest energy rise (decimated, once per grain restart) and returns
+     * the offset that puts it a quarter grain into the new grain, where the
+     * Hann window is already open. Returns 0 when nothing stands out.
+     */
+    int findTransientOffset(int nominalStart) const
+    {
+        constexpr int kHop = 16;
+        constexpr float kRiseThreshold = 4.0f;   // ~+6 dB amplitude jump
+        constexpr float kEnergyFloor = 1.0e-4f;
+        
+        const int searchStart = nominalStart - grainSize / 2;
+        const int numHops = grainSize / kHop;
+        
+        float previousEnergy = segmentEnergy(searchStart - kHop, kHop);
+        float bestRise = kRiseThreshold;
+        int bestPos = 0;
+        bool found = false;
+        
+        for (int hop = 0; hop < numHops; ++hop)
+        {
+            const int pos = searchStart + hop * kHop;
+            const float energy = segmentEnergy(pos, kHop);
+            const float rise = energy / (previousEnergy + kEnergyFloor);
+            if (energy > kEnergyFloor && rise > bestRise)
+            {
+                bestRise = rise;
+                bestPos = pos;
+                found = true;
+            }
+            previousEnergy = energy;
+        }
+        
+        // Positions are unwrapped (may be negative), so track the hit explicitly
+        if (!found)
+            return 0;
+        
+        // Transient a quarter grain in. The search spans half a grain either
+        // side, so the start moves at most G/4 later, well inside the two
+        // grains of latency a restart keeps behind the write head
+        return bestPos - grainSize / 4 - nominalStart;
+    }
+    
+    float segmentEnergy(int start, int length) const
+    {
+        float energy = 0.0f;
+        for (int i = 0; i < length; i += 2)
+        {
+            const int idx = (start + i) & bufferMask;
+            const float l = delayBuffer[static_cast<size_t>(idx * 2)];
+            const float r = delayBuffer[static_cast<size_t>(idx * 2 + 1)];
+            energy += l * l + r * r;
+        }
+        return energy;
+    }
+
+    /**
+     * One interpolated (L, R) frame. Uses the low two lanes of an SSE
+     * register or a NEON float32x2_t, so each grain tap is one load and one
+     * interpolation for both channels; plain floats elsewhere.
+     */
+    struct StereoFrame
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        __m128 v;
+        static StereoFrame zero() { return { _mm_setzero_ps() }; }
+        static StereoFrame load(const float* p) { return { _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))) }; }
+        static StereoFrame pair(float l, float r) { return { _mm_setr_ps(l, r, 0.0f, 0.0f) }; }
+        StereoFrame operator+(StereoFrame o) const { return { _mm_add_ps(v, o.v) }; }
+        StereoFrame operator-(StereoFrame o) const { return { _mm_sub_ps(v, o.v) }; }
+        StereoFrame operator*(StereoFrame o) const { return { _mm_mul_ps(v, o.v) }; }
+        StereoFrame operator*(float g) const { return { _mm_mul_ps(v, _mm_set1_ps(g)) }; }
+        void store(float& l, float& r) const
+        {
+            alignas(16) float out[4];
+            _mm_store_ps(out, v);
+            l = out[0];
+            r = out[1];
+        }
+       #elif JUCE_USE_ARM_NEON
+        float32x2_t v;
+        static StereoFrame zero() { return { vdup_n_f32(0.0f) }; }
+        static StereoFrame load(const float* p) { return { vld1_f32(p) }; }
+        static StereoFrame pair(float l, float r) { return { vset_lane_f32(r, vdup_n_f32(l), 1) }; }
+        StereoFrame operator+(StereoFrame o) const { return { vadd_f32(v, o.v) }; }
+        StereoFrame operator-(StereoFrame o) const { return { vsub_f32(v, o.v) }; }
+        StereoFrame operator*(StereoFrame o) const { return { vmul_f32(v, o.v) }; }
+        StereoFrame operator*(float g) const { return { vmul_n_f32(v, g) }; }
+        void store(float& l, float& r) const
+        {
+            l = vget_lane_f32(v, 0);
+            r = vget_lane_f32(v, 1);
+        }
+       #else
+        float l, r;
+        static StereoFrame zero() { return { 0.0f, 0.0f }; }
+        static StereoFrame load(const float* p) { return { p[0], p[1] }; }
+        static StereoFrame pair(float left, float right) { return { left, right }; }
+        StereoFrame operator+(StereoFrame o) const { return { l + o.l, r + o.r }; }
+        StereoFrame operator-(StereoFrame o) const { return { l - o.l, r - o.r }; }
+        StereoFrame operator*(StereoFrame o) const { return { l * o.l, r * o.r }; }
+        StereoFrame operator*(float g) const { return { l * g, r * g }; }
+        void store(float& outL, float& outR) const
+        {
+            outL = l;
+            outR = r;
+        }
+       #endif
+    };
+    
+    // Two grains' stereo frames side by side (L0 R0 L1 R1): the grain passes
+    // run two grains per vector op and fold the halves together at the end
+    struct GrainPair
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        __m128 v;
+        static GrainPair zero() { return { _mm_setzero_ps() }; }
+        static GrainPair load(const float* a, const float* b)
+        {
+            const __m128 lo = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(a)));
+            return { _mm_loadh_pi(lo, reinterpret_cast<const __m64*>(b)) };
+        }
+        static GrainPair pair(float a, float b) { return { _mm_setr_ps(a, a, b, b) }; }
+        static GrainPair gains(float l0, float r0, float l1, float r1) { return { _mm_setr_ps(l0, r0, l1, r1) }; }
+        GrainPair operator+(GrainPair o) const { return { _mm_add_ps(v, o.v) }; }
+        GrainPair operator-(GrainPair o) const { return { _mm_sub_ps(v, o.v) }; }
+        GrainPair operator*(GrainPair o) const { return { _mm_mul_ps(v, o.v) }; }
+        GrainPair operator*(float g) const { return { _mm_mul_ps(v, _mm_set1_ps(g)) }; }
+        StereoFrame sum() const  // Upper lanes zeroed, as StereoFrame expects
+        {
+            const __m128 zero = _mm_setzero_ps();
+            return { _mm_add_ps(_mm_movelh_ps(v, zero), _mm_movehl_ps(zero, v)) };
+        }
+       #elif JUCE_USE_ARM_NEON
+        float32x4_t v;
+        static GrainPair zero() { return { vdupq_n_f32(0.0f) }; }
+        static GrainPair load(const float* a, const float* b) { return { vcombine_f32(vld1_f32(a), vld1_f32(b)) }; }
+        static GrainPair pair(float a, float b) { return { vcombine_f32(vdup_n_f32(a), vdup_n_f32(b)) }; }
+        static GrainPair gains(float l0, float r0, float l1, float r1)
+        {
+            return { vcombine_f32(StereoFrame::pair(l0, r0).v, StereoFrame::pair(l1, r1).v) };
+        }
+        GrainPair operator+(GrainPair o) const { return { vaddq_f32(v, o.v) }; }
+        GrainPair operator-(GrainPair o) const { return { vsubq_f32(v, o.v) }; }
+        GrainPair operator*(GrainPair o) const { return { vmulq_f32(v, o.v) }; }
+        GrainPair operator*(float g) const { return { vmulq_n_f32(v, g) }; }
+        StereoFrame sum() const { return { vadd_f32(vget_low_f32(v), vget_high_f32(v)) }; }
+       #else
+        StereoFrame a, b;
+        static GrainPair zero() { return { StereoFrame::zero(), StereoFrame::zero() }; }
+        static GrainPair load(const float* pa, const float* pb) { return { StereoFrame::load(pa), StereoFrame::load(pb) }; }
+        static GrainPair pair(float ga, float gb) { return { StereoFrame::pair(ga, ga), StereoFrame::pair(gb, gb) }; }
+        static GrainPair gains(float l0, float r0, float l1, float r1)
+        {
+            return { StereoFrame::pair(l0, r0), StereoFrame::pair(l1, r1) };
+        }
+        GrainPair operator+(GrainPair o) const { return { a + o.a, b + o.b }; }
+        GrainPair operator-(GrainPair o) const { return { a - o.a, b - o.b }; }
+        GrainPair operator*(GrainPair o) const { return { a * o.a, b * o.b }; }
+        GrainPair operator*(float g) const { return { a * g, b * g }; }
+        StereoFrame sum() const { return a + b; }
+       #endif
+    };
+    
+    // Read position advanced past either end of the ring, wrapped back in
+    static double wrapPosition(double pos, double size)
+    {
+        return pos >= size ? pos - size : (pos < 0.0 ? pos + size : pos);
+    }
+    
+    // Two grains' read positions with the split into ring index and fraction
+    // and the advance-and-wrap, kept in one register so the pair is loaded
+    // and stored at the same width every sample
+    struct PositionPair
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        __m128d v;
+        static PositionPair load(const double* p) { return { _mm_loadu_pd(p) }; }
+        static PositionPair pair(double a, double b) { return { _mm_setr_pd(a, b) }; }
+        void store(double* p) const { _mm_storeu_pd(p, v); }
+        void split(int& indexA, int& indexB, GrainPair& frac) const
+        {
+            const __m128i index = _mm_cvttpd_epi32(v);  // Positions are never negative
+            const __m128 f = _mm_cvtpd_ps(_mm_sub_pd(v, _mm_cvtepi32_pd(index)));
+            indexA = _mm_cvtsi128_si32(index);
+            indexB = _mm_cvtsi128_si32(_mm_shuffle_epi32(index, 1));
+            frac = { _mm_unpacklo_ps(f, f) };
+        }
+        PositionPair advance(PositionPair step, double size) const
+        {
+            const __m128d s = _mm_set1_pd(size);
+            const __m128d p = _mm_add_pd(v, step.v);
+            return { _mm_add_pd(_mm_sub_pd(p, _mm_and_pd(_mm_cmpge_pd(p, s), s)),
+                                _mm_and_pd(_mm_cmplt_pd(p, _mm_setzero_pd()), s)) };
+        }
+       #else
+        double a, b;
+        static PositionPair load(const double* p) { return { p[0], p[1] }; }
+        static PositionPair pair(double pa, double pb) { return { pa, pb }; }
+        void store(double* p) const
+        {
+            p[0] = a;
+            p[1] = b;
+        }
+        void split(int& indexA, int& indexB, GrainPair& frac) const
+        {
+            indexA = static_cast<int>(a);
+            indexB = static_cast<int>(b);
+            frac = GrainPair::pair(static_cast<float>(a - indexA), static_cast<float>(b - indexB));
+        }
+        PositionPair advance(PositionPair step, double size) const
+        {
+            return { wrapPosition(a + step.a, size), wrapPosition(b + step.b, size) };
+        }
+       #endif
+    };
+    
+    // Window value at a Q16 grain phase (0 to grainSize << kPhaseBits)
+    float windowAt(const float* table, int phase) const
+    {
+        return GrainWindows::lookup(table, static_cast<float>(phase) * windowScale);
+    }
+
+    // Stores the input frame at writePos; the first kGuardSamples frames are
+    // mirrored past the end so reads starting near the end of the ring stay contiguous
+    void writeFrame(float left, float right)
+    {
+        delayBuffer[static_cast<size_t>(writePos * 2)] = left;
+        delayBuffer[static_cast<size_t>(writePos * 2 + 1)] = right;
+        if (writePos < kGuardSamples)
+        {
+            delayBuffer[static_cast<size_t>((bufferSize + writePos) * 2)] = left;
+            delayBuffer[static_cast<size_t>((bufferSize + writePos) * 2 + 1)] = right;
+        }
+    }
+    
+    // Interpolation kernels, shared by the single-frame and grain-pair reads
+    template <typename Frame, typename Frac>
+    static Frame linear(Frame x0, Frame x1, Frac frac)
+    {
+        return x0 + (x1 - x0) * frac;
+    }
+    
+    // HQ: 4-point Hermite, same kernel as ChorusEngine Deep mode
+    template <typename Frame, typename Frac>
+    static Frame hermite(Frame y0, Frame y1, Frame y2, Frame y3, Frac frac)
+    {
+        const Frame c0 = y1;
+        const Frame c1 = (y2 - y0) * 0.5f;
+        const Frame c2 = y0 - y1 * 2.5f + y2 * 2.0f - y3 * 0.5f;
+        const Frame c3 = (y3 - y0) * 0.5f + (y1 - y2) * 1.5f;
+        
+        return ((c3 * frac + c2) * frac + c1) * frac + c0;
+    }
+    
+    StereoFrame readLinear(int intPos, float frac) const
+    {
+        const float* x = delayBuffer.data() + (intPos & bufferMask) * 2;
+        return linear(StereoFrame::load(x), StereoFrame::load(x + 2), frac);
+    }
+    
+    GrainPair readLinear(int intPosA, int intPosB, GrainPair frac) const
+    {
+        const float* a = delayBuffer.data() + (intPosA & bufferMask) * 2;
+        const float* b = delayBuffer.data() + (intPosB & bufferMask) * 2;
+        return linear(GrainPair::load(a, b), GrainPair::load(a + 2, b + 2), frac);
+    }
+    
+    StereoFrame readHermite(int intPos, float frac) const
+    {
+        // Taps intPos-1 .. intPos+2, contiguous thanks to the guard frames
+        const float* x = delayBuffer.data() + ((intPos - 1) & bufferMask) * 2;
+        return hermite(StereoFrame::load(x), StereoFrame::load(x + 2),
+                       StereoFrame::load(x + 4), StereoFrame::load(x + 6), frac);
+    }
+    
+    GrainPair readHermite(int intPosA, int intPosB, GrainPair frac) const
+    {
+        const float* a = delayBuffer.data() + ((intPosA - 1) & bufferMask) * 2;
+        const float* b = delayBuffer.data() + ((intPosB - 1) & bufferMask) * 2;
+        return hermite(GrainPair::load(a, b), GrainPair::load(a + 2, b + 2),
+                       GrainPair::load(a + 4, b + 4), GrainPair::load(a + 6, b + 6), frac);
+    }
+    
+    // Polyphase windowed sinc (shared SincTable): each kernel coefficient is
+    // paired up to weight the interleaved L/R frames, two frames per vector
+    StereoFrame readSinc(int intPos, float frac) const
+    {
+        const float* x = delayBuffer.data() + ((intPos - SincTable::kTapsBefore) & bufferMask) * 2;
+        const SincTable::Kernel k = SincTable::getKernel(frac);
+       #if JUCE_USE_SSE_INTRINSICS
+        const __m128 t = _mm_set1_ps(k.t);
+        __m128 acc = _mm_setzero_ps();
+        for (int i = 0; i < SincTable::kTaps; i += 4)
+        {
+            const __m128 a = _mm_load_ps(k.a + i);
+            const __m128 c = _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(_mm_load_ps(k.b + i), a)));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + 2 * i), _mm_unpacklo_ps(c, c)));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + 2 * i + 4), _mm_unpackhi_ps(c, c)));
+        }
+        return { _mm_add_ps(acc, _mm_movehl_ps(acc, acc)) };
+       #elif JUCE_USE_ARM_NEON
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (int i = 0; i < SincTable::kTaps; i += 4)
+        {
+            const float32x4_t a = vld1q_f32(k.a + i);
+            const float32x4_t c = vmlaq_n_f32(a, vsubq_f32(vld1q_f32(k.b + i), a), k.t);
+            const float32x4x2_t paired = vzipq_f32(c, c);
+            acc = vmlaq_f32(acc, vld1q_f32(x + 2 * i), paired.val[0]);
+            acc = vmlaq_f32(acc, vld1q_f32(x + 2 * i + 4), paired.val[1]);
+        }
+        return { vadd_f32(vget_low_f32(acc), vget_high_f32(acc)) };
+       #else
+        float l = 0.0f, r = 0.0f;
+        for (int i = 0; i < SincTable::kTaps; ++i)
+        {
+            const float c = k.a[i] + k.t * (k.b[i] - k.a[i]);
+            l += x[2 * i] * c;
+            r += x[2 * i + 1] * c;
+        }
+        return { l, r };
+       #endif
+    }
     
+    // Both channels through the biquad cascade as one SIMD pair (TDF-II)
+    void applyAntiAlias(float& left, float& right)
+    {
+        alignas(8) const float in[2] = { left, right };
+        StereoFrame x = StereoFrame::load(in);
+        for (auto& stage : antiAliasStages)
+        {
+            const StereoFrame y = x * stage.b0 + stage.s1;
+            stage.s1 = x * stage.b1 - y * stage.a1 + stage.s2;
+            stage.s2 = x * stage.b2 - y * stage.a2;
+            x = y;
+        }
+        x.store(left, right);
+    }
+    
+    StereoFrame renderWet(std::array<double, kMaxVoices>& voiceRatio,
+                          const std::array<double, kMaxVoices>& ratioStep, int windowEnd)
+    {
+        if (tapeEnabled)
+            return renderTape(voiceRatio, ratioStep);
+        return cloudEnabled ? renderCloud(voiceRatio, ratioStep) : renderVoices(voiceRatio, ratioStep, windowEnd);
+    }
+    
+    // Tape head at the dry tap's delay, transport running when engaged
+    void resetTape()
+    {
+        const double pos = static_cast<double>(writePos - latencySamples);
+        tapePos = pos < 0.0 ? pos + bufferSize : pos;
+        tapeFade = 0;
+        tapeSpeed = isEngaged ? 1.0f : 0.0f;
+    }
+    
+    /**
+     * Tape: one sinc read at voice 0's ratio times the transport speed.
+     * While a splice crossfades, the outgoing head keeps playing under the
+     * first half of a grain window. The head splices when the next crossfade
+     * could no longer finish inside the readable span (see spliceTape).
+     */
+    StereoFrame renderTape(std::array<double, kMaxVoices>& voiceRatio,
+                           const std::array<double, kMaxVoices>& ratioStep)
+    {
+        voiceRatio[0] *= ratioStep[0];
+        
+        // Transport: linear spin up/down over the rise time, then the wet
+        // fades out once a disengaged tape has stopped
+        if (isEngaged)
+            tapeSpeed = juce::jmin(1.0f, tapeSpeed + tapeSpeedStep);
+        else if (tapeSpeed > 0.0f)
+            tapeSpeed = juce::jmax(0.0f, tapeSpeed - tapeSpeedStep);
+        else
+            wetGain.setTargetValue(0.0f);
+        
+        const double speed = voiceRatio[0] * tapeSpeed;
+        if (tapeFade == 0)
+            spliceTape(speed);
+        
+        const double step = reverse ? -speed : speed;
+        const double size = static_cast<double>(bufferSize);
+        
+        int intPos = static_cast<int>(tapePos);
+        StereoFrame frame = readSinc(intPos, static_cast<float>(tapePos - intPos));
+        if (tapeFade > 0)
+        {
+            const int half = grainSize / 2;
+            const int fadePos = half - tapeFade;
+            intPos = static_cast<int>(tapeFadePos);
+            frame = frame * windowAt(hannWindow, fadePos << kPhaseBits)
+                  + readSinc(intPos, static_cast<float>(tapeFadePos - intPos)) * windowAt(hannWindow, (fadePos + half) << kPhaseBits);
+            tapeFadePos = wrapPosition(tapeFadePos + step, size);
+            --tapeFade;
+        }
+        tapePos = wrapPosition(tapePos + step, size);
+        return frame;
+    }
+    
+    /**
+     * Keeps the tape head inside the readable span: at least a sinc kernel
+     * behind the write head, within what has been captured and clear of the
+     * frames it overwrites next (or, frozen, inside the loop), with room for
+     * a crossfade's worth of drift.
+     * A head running out of reach crossfades to a new head: a slow head
+     * jumps back up to the nominal delay; a fast one jumps kTapeReachSeconds
+     * back so it has audio to catch up on. Frozen, it wraps round the loop.
+     */
+    void spliceTape(double speed)
+    {
+        const double fade = grainSize / 2;
+        double minAge, maxAge;
+        if (frozen)
+        {
+            minAge = SincTable::kTaps + (reverse ? 0.0 : speed * fade);
+            maxAge = freezeLength - (reverse ? speed * fade : 0.0);
+        }
+        else
+        {
+            minAge = SincTable::kTaps + (reverse ? 0.0 : juce::jmax(0.0, speed - 1.0) * fade);
+            maxAge = juce::jmin(bufferSize - 8 * grainSize, capturedFrames);
+        }
+        if (maxAge <= minAge)
+            return;  // Frozen loop too short to play
+        
+        // Ages count back from the frame just written, like the dry tap
+        const double size = static_cast<double>(bufferSize);
+        double age = writePos - tapePos;
+        if (age < 0.0)
+            age += size;
+        
+        double target;
+        if (age < minAge)
+            target = frozen ? maxAge : juce::jmin(maxAge, latencySamples + kTapeReachSeconds * sampleRate);
+        else if (age > maxAge)
+            target = frozen ? minAge : juce::jmax(minAge, static_cast<double>(latencySamples));
+        else
+            return;
+        
+        tapeFadePos = tapePos;
+        tapeFade = grainSize / 2;
+        const double pos = writePos - target;
+        tapePos = pos < 0.0 ? pos + size : pos;
+    }
+    
+    /**
+     * Cloud: one sample of every playing cloud grain. Taps, gains and
+     * advances are flat passes over the packed SoA pool, so they vectorise
+     * over the playing grains; finished grains hand their slot to the last
+     * playing one.
+     */
+    StereoFrame renderCloud(std::array<double, kMaxVoices>& voiceRatio,
+                            const std::array<double, kMaxVoices>& ratioStep)
+    {
+        for (int v = 0; v < numVoices; ++v)
+            voiceRatio[static_cast<size_t>(v)] *= ratioStep[static_cast<size_t>(v)];
+        
+        if (--cloudCountdown <= 0)
+            spawnCloudGrain(voiceRatio);
+        
+        const double size = static_cast<double>(bufferSize);
+        const double direction = reverse ? -1.0 : 1.0;
+        auto stepOf = [&](size_t k)
+        {
+            return direction * voiceRatio[static_cast<size_t>(cloud.voice[k])] * cloud.detune[k];
+        };
+        
+        // Linear and Hermite reads go two grains at a time, as in processVoice
+        const auto n = static_cast<size_t>(cloudActive);
+        StereoFrame frame = StereoFrame::zero();
+        size_t k = 0;
+        if (!useSinc)
+        {
+            GrainPair sum = GrainPair::zero();
+            for (; k + 1 < n; k += 2)
+            {
+                const PositionPair pos = PositionPair::load(cloud.readPos.data() + k);
+                int indexA, indexB;
+                GrainPair frac;
+                pos.split(indexA, indexB, frac);
+                const GrainPair x = useHermite ? readHermite(indexA, indexB, frac) : readLinear(indexA, indexB, frac);
+                const float wA = windowAt(hannWindow, cloud.phase[k]);
+                const float wB = windowAt(hannWindow, cloud.phase[k + 1]);
+                sum = sum + x * GrainPair::gains(wA * cloud.gainL[k], wA * cloud.gainR[k],
+                                                 wB * cloud.gainL[k + 1], wB * cloud.gainR[k + 1]);
+                pos.advance(PositionPair::pair(stepOf(k), stepOf(k + 1)), size).store(cloud.readPos.data() + k);
+            }
+            frame = sum.sum();
+        }
+        
+        // Sinc reads, and the odd grain left over from the pairs
+        for (; k < n; ++k)
+        {
+            const double pos = cloud.readPos[k];
+            const int intPos = static_cast<int>(pos);
+            const float frac = static_cast<float>(pos - intPos);
+            const StereoFrame x = useSinc ? readSinc(intPos, frac)
+                                          : (useHermite ? readHermite(intPos, frac) : readLinear(intPos, frac));
+            const float w = windowAt(hannWindow, cloud.phase[k]);
+            frame = frame + x * StereoFrame::pair(w * cloud.gainL[k], w * cloud.gainR[k]);
+            cloud.readPos[k] = wrapPosition(pos + stepOf(k), size);
+        }
+        
+        for (k = 0; k < n; ++k)
+            cloud.phase[k] += cloud.phaseStep[k];
+        
+        // Finished grains are replaced by the last playing one
+        const int windowEnd = grainSize << kPhaseBits;
+        for (size_t i = 0; i < static_cast<size_t>(cloudActive);)
+        {
+            if (cloud.phase[i] >= windowEnd)
+                moveCloudGrain(static_cast<size_t>(--cloudActive), i);
+            else
+                ++i;
+        }
+        return frame;
+    }
+    
+    /**
+     * Starts one cloud grain and schedules the next. Onsets are jittered
+     * around cloudLength / cloudOverlap so the pool holds cloudOverlap
+     * grains on average (a full pool skips the spawn). Each grain reads a
+     * span that ends (forward) or starts (reverse) at a random age behind
+     * the write head, or behind the freeze scan, kept far enough back that
+     * the whole span stays readable.
+     */
+    void spawnCloudGrain(const std::array<double, kMaxVoices>& voiceRatio)
+    {
+        const double interval = cloudLength / cloudOverlap;
+        cloudCountdown = juce::jmax(1, static_cast<int>(interval * (0.5 + cloudRandom.nextFloat())));
+        if (cloudActive == kCloudGrains)
+            return;
+        
+        const int v = numVoices > 1 ? cloudRandom.nextInt(numVoices) : 0;
+        const double detune = FastMath::fastExp2(cloudScatter * (2.0 * cloudRandom.nextFloat() - 1.0));
+        const double stretch = FastMath::fastExp2(cloudScatter * (2.0 * cloudRandom.nextFloat() - 1.0));
+        const int step = juce::jmax(1, static_cast<int>(grainSize * kPhaseOne / (cloudLength * stretch)));
+        const double length = static_cast<double>(grainSize) * kPhaseOne / step;
+        const double span = voiceRatio[static_cast<size_t>(v)] * detune * length;
+        
+        // Oldest end of the span, as an age behind the next write
+        const double jitter = (grainSize + cloudSpread * kCloudScatterSeconds * sampleRate) * cloudRandom.nextFloat();
+        double age;
+        if (frozen)
+        {
+            const double minAge = span + SincTable::kTaps;
+            if (minAge > freezeLength)
+                return;
+            age = juce::jlimit(minAge, static_cast<double>(freezeLength),
+                               static_cast<double>(freezeLength - freezeScan) + jitter);
+        }
+        else
+        {
+            const double minAge = span + SincTable::kTaps - (reverse ? 0.0 : length);
+            age = juce::jmax(minAge, latencySamples + jitter);
+        }
+        if (reverse)
+            age -= span;
+        
+        const double size = static_cast<double>(bufferSize);
+        const double pos = static_cast<double>(writePos + 1) - age;
+        
+        // Equal-power pan, unity at the centre
+        const float pan = cloudSpread * (2.0f * cloudRandom.nextFloat() - 1.0f);
+        const float angle = (pan + 1.0f) * 0.25f * juce::MathConstants<float>::pi;
+        
+        const auto k = static_cast<size_t>(cloudActive++);
+        cloud.readPos[k] = pos < 0.0 ? pos + size : pos;
+        cloud.detune[k] = static_cast<float>(detune);
+        cloud.gainL[k] = juce::MathConstants<float>::sqrt2 * std::cos(angle) * cloudGain;
+        cloud.gainR[k] = juce::MathConstants<float>::sqrt2 * std::sin(angle) * cloudGain;
+        cloud.phase[k] = 0;
+        cloud.phaseStep[k] = step;
+        cloud.voice[k] = v;
+    }
+    
+    void moveCloudGrain(size_t from, size_t to)
+    {
+        cloud.readPos[to] = cloud.readPos[from];
+        cloud.detune[to] = cloud.detune[from];
+        cloud.gainL[to] = cloud.gainL[from];
+        cloud.gainR[to] = cloud.gainR[from];
+        cloud.phase[to] = cloud.phase[from];
+        cloud.phaseStep[to] = cloud.phaseStep[from];
+        cloud.voice[to] = cloud.voice[from];
+    }
+    
+    // All voices for one sample; every voice reads the same delay line
+    StereoFrame renderVoices(std::array<double, kMaxVoices>& voiceRatio,
+                             const std::array<double, kMaxVoices>& ratioStep, int windowEnd)
+    {
+        StereoFrame wetFrame = StereoFrame::zero();
+        for (int v = 0; v < numVoices; ++v)
+        {
+            // Glide/portamento step
+            voiceRatio[static_cast<size_t>(v)] *= ratioStep[static_cast<size_t>(v)];
+            wetFrame = wetFrame + processVoice(voices[static_cast<size_t>(v)], voiceRatio[static_cast<size_t>(v)], windowEnd);
+        }
+        if (numVoices > 1)
+            wetFrame = wetFrame * voiceGain;
+        return wetFrame;
+    }
+    
+    // One voice for one sample: windowed grain reads, then advance and restart
+    StereoFrame processVoice(Voice& voice, double ratio, int windowEnd)
+    {
+        const double size = static_cast<double>(bufferSize);
+        const double step = reverse ? -ratio : ratio;
+        
+        // Windowed reads, advancing and wrapping each read position. numGrains
+        // is always even, so linear and Hermite reads go two grains at a time
+        const auto n = static_cast<size_t>(numGrains);
+        StereoFrame frame = StereoFrame::zero();
+        if (useSinc)
+        {
+            for (size_t g = 0; g < n; ++g)
+            {
+                const double pos = voice.grainReadPos[g];
+                const int intPos = static_cast<int>(pos);
+                frame = frame + readSinc(intPos, static_cast<float>(pos - intPos)) * windowAt(window, voice.grainPhase[g]);
+                voice.grainReadPos[g] = wrapPosition(pos + step, size);
+            }
+        }
+        else
+        {
+            const PositionPair stepPair = PositionPair::pair(step, step);
+            GrainPair sum = GrainPair::zero();
+            for (size_t g = 0; g < n; g += 2)
+            {
+                const PositionPair pos = PositionPair::load(voice.grainReadPos.data() + g);
+                int indexA, indexB;
+                GrainPair frac;
+                pos.split(indexA, indexB, frac);
+                const GrainPair x = useHermite ? readHermite(indexA, indexB, frac) : readLinear(indexA, indexB, frac);
+                sum = sum + x * GrainPair::pair(windowAt(window, voice.grainPhase[g]), windowAt(window, voice.grainPhase[g + 1]));
+                pos.advance(stepPair, size).store(voice.grainReadPos.data() + g);
+            }
+            frame = sum.sum();
+        }
+        frame = frame * grainGain;
+        
+        for (size_t g = 0; g < n; ++g)
+            voice.grainPhase[g] += phaseStep;
+        
+        // Reset grains when they complete - resync to avoid drift
+        for (size_t g = 0; g < n; ++g)
+        {
+            if (voice.grainPhase[g] >= windowEnd)
+            {
+                voice.grainPhase[g] -= windowEnd;  // Keeps the stagger exact when stretched
+                voice.grainReadPos[g] = getGrainStartPosition(voice, static_cast<int>(g), ratio);
+                if (onsetActive && !reverse)
+                    voice.grainReadPos[g] = placeAroundOnset(voice, voice.grainReadPos[g], ratio);
+            }
+        }
+        return frame;
+    }
+    
+    double sampleRate = 44100.0;
+    int bufferSize = 8192;
+    int bufferMask = 8191;
+    int grainSize = 441;
+    int grainMs = 0;                 // 0 until prepare()
+    int latencySamples = 1764;       // The latency budget, see setLatencyBudget
+    double latencyBudgetMs = 40.0;
+    int dryFade = 0;                 // Dry tap crossfade samples left
+    int dryFadeFrom = 0;             // Dry tap delay before the latency change
+    int dryFadeLength = 882;
+    
+    std::vector<float> delayBuffer;  // Interleaved L/R frames
+    std::vector<float> captureBuffer;  // Staged capture ring, then the old ring until the next prepare
+    std::vector<float> dryBuffer;    // Unfiltered input for the dry tap, interleaved L/R frames
+    int dryMask = 4095;
+    std::atomic<bool> captureStaged { false };
+    std::atomic<bool> captureRequested { false };  // Freeze has been engaged
+    std::atomic<bool> captureEnabled { false };    // Ring sized for kCaptureSeconds
+    const float* window = GrainWindows::get(GrainWindows::Shape::Hann);      // Voice grains (shared, read-only)
+    const float* hannWindow = GrainWindows::get(GrainWindows::Shape::Hann);  // Cloud grains and tape splices
+    float windowScale = 1.0f / 441.0f * GrainWindows::kSize / kPhaseOne;    // Table entries per Q16 phase unit
+    GrainWindows::Shape windowShape = GrainWindows::Shape::Hann;
+    
+    int writePos = 0;
+    std::array<Voice, kMaxVoices> voices {};
+    int phaseStep = kPhaseOne;       // Window advance per sample (Q16)
+    double glideLog2Decay = -0.00144;  // Per sample, see updateGlideCoeff
     double modulationOffset = 0.0;  // In semitones
+    double heldOffset = 0.0;        // In semitones, see setHeldOffset
+    
+    int numGrains = 2;
+    int numVoices = 1;
+    float voiceGain = 1.0f;
+    float grainGain = 1.0f;
+    bool useHermite = false;
+    bool useSinc = false;
+    bool lookaheadEnabled = false;
+    bool onsetSyncEnabled = false;
+    bool frozen = false;
+    bool reverse = false;
+    int freezeLength = 0;            // Frames in the frozen loop, ending at writePos
+    int freezeScan = 0;              // Restart position within the loop
+    int capturedFrames = 0;          // Frames written since reset, up to bufferSize
+    bool onsetActive = false;        // An attack is still inside some grain's reach
+    int onsetPos = 0;
+    GrainMode grainMode = GrainMode::Fixed;
     bool isEngaged = true;
+    double grainPeriod = 0.0;        // PSOLA: detected period, 0 when unvoiced
     
     juce::SmoothedValue<float> wetGain{1.0f};
+    const SimdKernels::Table* kernels = &SimdKernels::getTable(SimdKernels::Isa::Scalar);
+    PeriodDetector periodDetector;
+    OnsetDetector onsetDetector;
+    
+    CloudGrains cloud;
+    int cloudActive = 0;             // Playing cloud grains, packed at the front
+    int cloudCountdown = 0;          // Samples to the next spawn
+    bool cloudEnabled = false;
+    float cloudOverlap = 36.0f;
+    float cloudGain = 1.0f / std::sqrt(36.0f * 0.375f);
+    float cloudSpread = 0.0f;
+    float cloudScatter = 0.0f;
+    double cloudLength = 1764.0;     // Mean grain length in samples
+    juce::Random cloudRandom;
+    
+    bool tapeEnabled = false;
+    double tapePos = 0.0;            // Tape read head
+    double tapeFadePos = 0.0;        // Outgoing head while a splice crossfades
+    int tapeFade = 0;                // Crossfade samples left
+    float tapeSpeed = 1.0f;          // Transport, 0 (stopped) to 1
+    float tapeSpeedStep = 0.0005f;   // Per sample, one rise time from 0 to 1
+    
+    struct AntiAliasStage
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        StereoFrame s1 = StereoFrame::zero();
+        StereoFrame s2 = StereoFrame::zero();
+    };
+    std::array<AntiAliasStage, 2> antiAliasStages {};
+    double antiAliasLog2 = 0.0;     // Ratio the coefficients were built for
+    bool antiAliasActive = false;
 };
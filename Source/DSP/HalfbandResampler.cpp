@@ -0,0 +1,216 @@
+#include "HalfbandResampler.h"
+#include <cmath>
+
+namespace {
+    // Outer stages see a wide transition band, the stage next to the internal
+    // rate has to be steep enough to keep 20 kHz while rejecting above 24 kHz
+    constexpr int kOuterStageTaps = 19;
+    constexpr int kInnerStageTaps = 63;
+    constexpr double kKaiserBeta = 8.0;
+
+    double besselI0(double x) {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+}
+
+void HalfbandResampler::Stage::design(int taps) {
+    // taps = 4K + 3 so that the centre tap sits on an odd index
+    numTaps = taps;
+    const int centre = (taps - 1) / 2;
+    const int numSide = (taps + 1) / 4;
+    sideTaps.assign(static_cast<size_t>(numSide), 0.0f);
+
+    double sum = 0.0;
+    std::vector<double> side(static_cast<size_t>(numSide));
+    for (int j = 0; j < numSide; ++j) {
+        const int k = 2 * j;
+        const double x = (k - centre) * 0.5;
+        const double sinc = std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+        const double r = 2.0 * k / (taps - 1) - 1.0;
+        const double window = besselI0(kKaiserBeta * std::sqrt(1.0 - r * r)) / besselI0(kKaiserBeta);
+        side[static_cast<size_t>(j)] = 0.5 * sinc * window;
+        sum += side[static_cast<size_t>(j)];
+    }
+
+    // Normalise for unity DC gain: both sides together contribute 0.5
+    for (int j = 0; j < numSide; ++j)
+        sideTaps[static_cast<size_t>(j)] = static_cast<float>(side[static_cast<size_t>(j)] * 0.25 / sum);
+
+    const int upLength = (taps + 1) / 2;
+    for (auto& h : downHistory) h.assign(static_cast<size_t>(taps * 2), 0.0f);
+    for (auto& h : upHistory) h.assign(static_cast<size_t>(upLength * 2), 0.0f);
+    reset();
+}
+
+void HalfbandResampler::Stage::reset() {
+    for (auto& h : downHistory) std::fill(h.begin(), h.end(), 0.0f);
+    for (auto& h : upHistory) std::fill(h.begin(), h.end(), 0.0f);
+    downPos = 0;
+    upPos = 0;
+    downPhase = false;
+}
+
+int HalfbandResampler::Stage::processDown(const float* input, float* output, int numSamples, int channel) {
+    auto& history = downHistory[static_cast<size_t>(channel)];
+    const int centre = (numTaps - 1) / 2;
+    const int numSide = static_cast<int>(sideTaps.size());
+    int pos = downPos;
+    bool phase = downPhase;
+    int numOut = 0;
+
+    for (int i = 0; i < numSamples; ++i) {
+        // Double-written history: the newest numTaps samples are contiguous
+        history[static_cast<size_t>(pos)] = input[i];
+        history[static_cast<size_t>(pos + numTaps)] = input[i];
+        const float* x = history.data() + pos + numTaps;  // x[-k] = k samples ago
+        pos = (pos + 1) % numTaps;
+
+        phase = !phase;
+        if (phase)
+            continue;
+
+        float y = 0.5f * x[-centre];
+        for (int j = 0; j < numSide; ++j)
+            y += sideTaps[static_cast<size_t>(j)] * (x[-2 * j] + x[-(numTaps - 1 - 2 * j)]);
+        output[numOut++] = y;
+    }
+
+    return numOut;
+}
+
+void HalfbandResampler::Stage::processUp(const float* input, float* output, int numSamples, int channel) {
+    auto& history = upHistory[static_cast<size_t>(channel)];
+    const int length = (numTaps + 1) / 2;
+    const int numSide = static_cast<int>(sideTaps.size());
+    const int centreDelay = (numTaps - 3) / 4;
+    int pos = upPos;
+
+    for (int i = 0; i < numSamples; ++i) {
+        history[static_cast<size_t>(pos)] = input[i];
+        history[static_cast<size_t>(pos + length)] = input[i];
+        const float* x = history.data() + pos + length;
+        pos = (pos + 1) % length;
+
+        // Even output: odd-offset taps (x2 for the zero-stuffing gain loss)
+        float y = 0.0f;
+        for (int j = 0; j < numSide; ++j)
+            y += sideTaps[static_cast<size_t>(j)] * (x[-j] + x[-(length - 1 - j)]);
+        output[2 * i] = 2.0f * y;
+
+        // Odd output: only the centre tap (0.5 x 2) is non-zero
+        output[2 * i + 1] = x[-centreDelay];
+    }
+}
+
+void HalfbandResampler::Stage::advanceDown(int numSamples) {
+    downPos = (downPos + numSamples) % numTaps;
+    if (numSamples % 2 != 0)
+        downPhase = !downPhase;
+}
+
+void HalfbandResampler::Stage::advanceUp(int numSamples) {
+    upPos = (upPos + numSamples) % ((numTaps + 1) / 2);
+}
+
+void HalfbandResampler::prepare(int numChannels, int maxBlockSize, int numStages) {
+    mNumChannels = juce::jlimit(1, 2, numChannels);
+    mMaxBlockSize = maxBlockSize;
+    mNumStages = juce::jlimit(0, kMaxStages, numStages);
+
+    for (int s = 0; s < mNumStages; ++s)
+        mStages[static_cast<size_t>(s)].design(s == mNumStages - 1 ? kInnerStageTaps : kOuterStageTaps);
+
+    for (auto& ch : mScratch) ch.assign(static_cast<size_t>(maxBlockSize + 2), 0.0f);
+    for (auto& ch : mFifo) ch.assign(static_cast<size_t>(maxBlockSize + getFactor() * 2), 0.0f);
+
+    reset();
+}
+
+void HalfbandResampler::reset() {
+    for (int s = 0; s < mNumStages; ++s)
+        mStages[static_cast<size_t>(s)].reset();
+
+    // Prefill so a block never runs short while the decimators wait for
+    // a full factor-aligned group of input samples
+    for (auto& ch : mFifo) std::fill(ch.begin(), ch.end(), 0.0f);
+    mFifoCount = getFactor() - 1;
+}
+
+int HalfbandResampler::getLatencySamples() const {
+    // Each stage: (taps - 1) at its own outer rate, minus the one-sample
+    // advance from emitting on the odd input; plus the FIFO prefill
+    int latency = getFactor() - 1;
+    for (int s = 0; s < mNumStages; ++s)
+        latency += (mStages[static_cast<size_t>(s)].numTaps - 2) << s;
+    return latency;
+}
+
+int HalfbandResampler::processDown(const float* const* input, float* const* output, int numChannels, int numSamples) {
+    numChannels = juce::jmin(numChannels, mNumChannels);
+
+    if (mNumStages == 0) {
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::copy(output[ch], input[ch], numSamples);
+        return numSamples;
+    }
+
+    int numOut = 0;
+    int numFirst = 0;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        if (mNumStages == 1) {
+            numOut = mStages[0].processDown(input[ch], output[ch], numSamples, ch);
+        } else {
+            auto* scratch = mScratch[static_cast<size_t>(ch)].data();
+            numFirst = mStages[0].processDown(input[ch], scratch, numSamples, ch);
+            numOut = mStages[1].processDown(scratch, output[ch], numFirst, ch);
+        }
+    }
+
+    mStages[0].advanceDown(numSamples);
+    if (mNumStages > 1)
+        mStages[1].advanceDown(numFirst);
+
+    return numOut;
+}
+
+void HalfbandResampler::processUp(const float* const* input, int numInternalSamples,
+                                  float* const* output, int numChannels, int numSamples) {
+    numChannels = juce::jmin(numChannels, mNumChannels);
+
+    if (mNumStages == 0) {
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::copy(output[ch], input[ch], numSamples);
+        return;
+    }
+
+    const int numProduced = numInternalSamples * getFactor();
+    for (int ch = 0; ch < numChannels; ++ch) {
+        auto* fifo = mFifo[static_cast<size_t>(ch)].data();
+        if (mNumStages == 1) {
+            mStages[0].processUp(input[ch], fifo + mFifoCount, numInternalSamples, ch);
+        } else {
+            auto* scratch = mScratch[static_cast<size_t>(ch)].data();
+            mStages[1].processUp(input[ch], scratch, numInternalSamples, ch);
+            mStages[0].processUp(scratch, fifo + mFifoCount, numInternalSamples * 2, ch);
+        }
+
+        const int available = mFifoCount + numProduced;
+        const int numCopy = juce::jmin(numSamples, available);
+        juce::FloatVectorOperations::copy(output[ch], fifo, numCopy);
+        if (numCopy < numSamples)
+            juce::FloatVectorOperations::clear(output[ch] + numCopy, numSamples - numCopy);
+        std::copy(fifo + numCopy, fifo + available, fifo);
+    }
+
+    if (mNumStages > 1)
+        mStages[1].advanceUp(numInternalSamples);
+    mStages[0].advanceUp(numInternalSamples * (mNumStages > 1 ? 2 : 1));
+
+    mFifoCount = juce::jmax(0, mFifoCount + numProduced - numSamples);
+}
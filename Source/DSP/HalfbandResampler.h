@@ -0,0 +1,67 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+/**
+ * HalfbandResampler - Polyphase half-band FIR decimator/interpolator pair
+ * used to run the expensive stages at an internal ~48 kHz when the host
+ * runs at 88.2/96 kHz (1 stage, 2x) or 176.4/192 kHz (2 stages, 4x).
+ *
+ * Half-band filters have every other tap at zero, so each stage only
+ * evaluates the odd-offset taps plus the centre tap. The filters are
+ * linear phase, so the round trip down + up is a pure integer delay.
+ */
+class HalfbandResampler {
+public:
+    static constexpr int kMaxStages = 2;
+
+    HalfbandResampler() = default;
+    ~HalfbandResampler() = default;
+
+    void prepare(int numChannels, int maxBlockSize, int numStages);
+    void reset();
+
+    int getNumStages() const { return mNumStages; }
+    int getFactor() const { return 1 << mNumStages; }
+    int getMaxInternalBlockSize() const { return mMaxBlockSize / getFactor() + 1; }
+
+    // Round trip (down + up) delay in host-rate samples
+    int getLatencySamples() const;
+
+    // Host rate -> internal rate. Returns the number of internal samples written.
+    int processDown(const float* const* input, float* const* output, int numChannels, int numSamples);
+
+    // Internal rate -> host rate. Always writes exactly numSamples host-rate samples.
+    void processUp(const float* const* input, int numInternalSamples,
+                   float* const* output, int numChannels, int numSamples);
+
+private:
+    struct Stage {
+        int numTaps = 0;
+        std::vector<float> sideTaps;            // Non-zero taps left of centre (h[0], h[2], ...)
+        std::array<std::vector<float>, 2> downHistory;
+        std::array<std::vector<float>, 2> upHistory;
+        int downPos = 0;
+        int upPos = 0;
+        bool downPhase = false;
+
+        void design(int taps);
+        void reset();
+        int processDown(const float* input, float* output, int numSamples, int channel);
+        void processUp(const float* input, float* output, int numSamples, int channel);
+        void advanceDown(int numSamples);
+        void advanceUp(int numSamples);
+    };
+
+    int mNumStages = 0;
+    int mNumChannels = 2;
+    int mMaxBlockSize = 512;
+
+    std::array<Stage, kMaxStages> mStages;
+    std::array<std::vector<float>, 2> mScratch;
+
+    // Up path FIFO: absorbs the block-to-block jitter of factor-aligned output
+    std::array<std::vector<float>, 2> mFifo;
+    int mFifoCount = 0;
+};
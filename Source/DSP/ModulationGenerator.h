@@ -63,22 +63,24 @@ public:
      * Returns combined pitch modulation in semitones.
      * Panic: slow detuning (up to ±12 semitones)
      * Chaos: random jumps (up to ±24 semitones)
+     * numSamples > 1 advances the generators by a whole control period at once.
      */
-    float getPitchModulation()
+    float getPitchModulation(int numSamples = 1)
     {
         float result = 0.0f;
+        const double elapsed = static_cast<double>(numSamples) / sampleRate;
         
         // === PANIC: Slow smooth random pitch drift ===
         if (panicAmount > 0.001f)
         {
-            panicPhase += panicFreq / sampleRate;
+            panicPhase += panicFreq * elapsed;
             if (panicPhase >= 1.0)
             {
-                panicPhase -= 1.0;
+                panicPhase -= std::floor(panicPhase);
                 panicTarget = dist(rng);
             }
             
-            float smoothCoeff = static_cast<float>(1.0 - std::exp(-panicFreq * 2.0 / sampleRate));
+            float smoothCoeff = static_cast<float>(1.0 - std::exp(-panicFreq * 2.0 * elapsed));
             smoothedRandom += smoothCoeff * (panicTarget - smoothedRandom);
             
             // Up to ±12 semitones at 100% panic
@@ -88,14 +90,14 @@ public:
         // === CHAOS: Fast random pitch jumps ===
         if (chaosAmount > 0.001f)
         {
-            chaosSampleCounter++;
+            chaosSampleCounter += numSamples;
             if (chaosSampleCounter >= chaosSamplesPerJump)
             {
-                chaosSampleCounter = 0;
+                chaosSampleCounter %= chaosSamplesPerJump;
                 chaosTarget = dist(rng);
             }
             
-            float chaosSmooth = static_cast<float>(1.0 - std::exp(-chaosFreq * 4.0 / sampleRate));
+            float chaosSmooth = static_cast<float>(1.0 - std::exp(-chaosFreq * 4.0 * elapsed));
             currentChaos += chaosSmooth * (chaosTarget - currentChaos);
             
             // Up to ±24 semitones at 100% chaos
@@ -105,6 +107,12 @@ public:
         return result;
     }
     
+    // True while Panic or Chaos produce pitch modulation
+    bool isPitchModulationActive() const
+    {
+        return panicAmount > 0.001f || chaosAmount > 0.001f;
+    }
+    
     /**
      * Returns FM modulation factor for Speed parameter.
      * High-frequency oscillation applied to the signal.
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+
+/**
+ * OnsetDetector - Cheap energy-slope onset detector for grain resyncs.
+ *
+ * Input energy is summed over short hops (one multiply-add per sample);
+ * at the end of each hop the hop energy is compared against a slow
+ * envelope of past hops. A jump of more than kRiseRatio over the envelope
+ * is an onset, after which detection holds off for about one note attack
+ * so a single pick doesn't trigger twice.
+ */
+class OnsetDetector
+{
+public:
+    static constexpr int kHopSize = 64;
+    static constexpr float kRiseRatio = 4.0f;       // Energy, ~+6 dB over the recent level
+    static constexpr float kEnergyFloor = 1.0e-4f;  // Per hop, ignores noise-floor wobble
+    static constexpr double kEnvelopeSeconds = 0.05;
+    static constexpr double kHoldoffSeconds = 0.06;
+
+    void prepare(double sampleRate)
+    {
+        slowCoeff = static_cast<float>(std::exp(-kHopSize / (kEnvelopeSeconds * sampleRate)));
+        holdoffHops = juce::jmax(1, static_cast<int>(std::ceil(kHoldoffSeconds * sampleRate / kHopSize)));
+        reset();
+    }
+
+    void reset()
+    {
+        energy = 0.0f;
+        slowEnergy = 0.0f;
+        count = 0;
+        holdoff = 0;
+    }
+
+    // Per input sample (mono sum). True at the end of a hop that holds an onset.
+    bool pushSample(float x)
+    {
+        energy += x * x;
+        if (++count < kHopSize)
+            return false;
+
+        const float hopEnergy = energy;
+        energy = 0.0f;
+        count = 0;
+
+        const bool onset = holdoff == 0 && hopEnergy > kEnergyFloor && hopEnergy > kRiseRatio * slowEnergy;
+        slowEnergy = hopEnergy + slowCoeff * (slowEnergy - hopEnergy);
+        if (onset)
+            holdoff = holdoffHops;
+        else if (holdoff > 0)
+            --holdoff;
+        return onset;
+    }
+
+private:
+    float energy = 0.0f;
+    float slowEnergy = 0.0f;
+    float slowCoeff = 0.9f;
+    int count = 0;
+    int holdoff = 0;
+    int holdoffHops = 45;
+};
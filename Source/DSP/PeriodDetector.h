@@ -0,0 +1,148 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+
+/**
+ * PeriodDetector - Lightweight monophonic period tracker for pitch-synchronous
+ * grains (guitar/bass range, 40 Hz - 1 kHz).
+ *
+ * Input is box-averaged down to ~6 kHz as it arrives (one add per sample).
+ * update() is called at control rate and runs a YIN-style cumulative mean
+ * normalized difference over the decimated history once per analysis hop
+ * (~20 ms), so the cost is a few multiply-adds per input sample on average.
+ * The dip is refined with a parabola and reported in input samples
+ * (accurate to about one decimation step, callers holding the full-rate
+ * signal can refine it further); 0 means unvoiced / no stable period.
+ */
+class PeriodDetector
+{
+public:
+    static constexpr int kHistorySize = 512;         // Decimated samples, power of two
+    static constexpr int kWindowSize = 128;          // Difference function window
+    static constexpr float kMinFrequency = 40.0f;
+    static constexpr float kMaxFrequency = 1000.0f;
+    static constexpr float kVoicedThreshold = 0.2f;  // CMND dip depth for a voiced frame
+
+    void prepare(double sampleRate)
+    {
+        decimation = juce::jmax(1, static_cast<int>(std::round(sampleRate / 6000.0)));
+        const double decimatedRate = sampleRate / decimation;
+        minLag = juce::jmax(2, static_cast<int>(decimatedRate / kMaxFrequency));
+        maxLag = juce::jmin(kHistorySize - kWindowSize - 2, static_cast<int>(decimatedRate / kMinFrequency));
+        hopSize = kWindowSize;
+        reset();
+    }
+
+    void reset()
+    {
+        history.fill(0.0f);
+        historyPos = 0;
+        accumulator = 0.0f;
+        accumulated = 0;
+        samplesSinceUpdate = 0;
+        period = 0.0;
+    }
+
+    // Per input sample (mono sum)
+    void pushSample(float x)
+    {
+        accumulator += x;
+        if (++accumulated == decimation)
+        {
+            history[static_cast<size_t>(historyPos)] = accumulator;
+            historyPos = (historyPos + 1) & (kHistorySize - 1);
+            accumulator = 0.0f;
+            accumulated = 0;
+            ++samplesSinceUpdate;
+        }
+    }
+
+    // Control rate: re-analyses once a hop of new decimated input is in.
+    // Returns true when the period estimate was refreshed.
+    bool update()
+    {
+        if (samplesSinceUpdate < hopSize)
+            return false;
+        samplesSinceUpdate = 0;
+        period = analyse();
+        return true;
+    }
+
+    // Detected period in input samples, 0 when unvoiced
+    double getPeriod() const { return period; }
+    int getDecimation() const { return decimation; }
+
+private:
+    double analyse()
+    {
+        // Latest window + maxLag decimated samples, oldest first
+        const int length = kWindowSize + maxLag + 1;
+        int pos = (historyPos - length) & (kHistorySize - 1);
+        for (int i = 0; i < length; ++i)
+        {
+            frame[static_cast<size_t>(i)] = history[static_cast<size_t>(pos)];
+            pos = (pos + 1) & (kHistorySize - 1);
+        }
+
+        // Cumulative mean normalized difference; the first lag that dips
+        // under the threshold is followed down to its local minimum
+        float runningSum = 0.0f;
+        int bestLag = -1;
+        for (int lag = 1; lag <= maxLag; ++lag)
+        {
+            cmnd[static_cast<size_t>(lag)] = difference(lag);
+            runningSum += cmnd[static_cast<size_t>(lag)];
+            cmnd[static_cast<size_t>(lag)] *= runningSum > 0.0f ? static_cast<float>(lag) / runningSum : 1.0f;
+
+            if (lag > minLag && bestLag < 0 && cmnd[static_cast<size_t>(lag - 1)] < kVoicedThreshold
+                && cmnd[static_cast<size_t>(lag)] >= cmnd[static_cast<size_t>(lag - 1)])
+            {
+                bestLag = lag - 1;
+                break;
+            }
+        }
+        if (bestLag < 0)
+            return 0.0;
+
+        // Parabolic refinement around the dip (the loop stopped one lag past it)
+        double lag = bestLag;
+        {
+            const float a = cmnd[static_cast<size_t>(bestLag - 1)];
+            const float b = cmnd[static_cast<size_t>(bestLag)];
+            const float c = cmnd[static_cast<size_t>(bestLag + 1)];
+            const float denominator = a - 2.0f * b + c;
+            if (std::abs(denominator) > 1.0e-9f)
+                lag += juce::jlimit(-0.5, 0.5, 0.5 * static_cast<double>(a - c) / static_cast<double>(denominator));
+        }
+        return lag * decimation;
+    }
+
+    // Squared difference of the window against itself lag samples earlier
+    float difference(int lag) const
+    {
+        const float* current = frame.data() + maxLag + 1;
+        const float* delayed = current - lag;
+        float sum = 0.0f;
+        for (int i = 0; i < kWindowSize; ++i)
+        {
+            const float d = current[i] - delayed[i];
+            sum += d * d;
+        }
+        return sum;
+    }
+
+    std::array<float, kHistorySize> history {};
+    std::array<float, kHistorySize> frame {};
+    std::array<float, kHistorySize> cmnd {};
+    int historyPos = 0;
+    float accumulator = 0.0f;
+    int accumulated = 0;
+    int samplesSinceUpdate = 0;
+    int decimation = 8;
+    int minLag = 6;
+    int maxLag = 150;
+    int hopSize = kWindowSize;
+    double period = 0.0;
+};
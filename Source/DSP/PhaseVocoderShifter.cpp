@@ -0,0 +1,310 @@
+#include "PhaseVocoderShifter.h"
+#include "FastMath.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+    constexpr float kTwoPi = juce::MathConstants<float>::twoPi;
+    constexpr double kLifterSeconds = 0.0015;  // Envelope detail down to ~670 Hz, above voice pitch periods
+    constexpr float kPowerFloor = 1.0e-12f;
+    constexpr float kMaxFormantGain = 64.0f;   // +36 dB, keeps noise in spectral holes down
+
+    inline float wrapPhase(float phase) {
+        return phase - kTwoPi * std::round(phase * (1.0f / kTwoPi));
+    }
+}
+
+void PhaseVocoderShifter::prepare(double sampleRate, int /*maxBlockSize*/) {
+    mSampleRate = sampleRate;
+
+    // Every supported frame size is allocated up front so size and overlap
+    // changes on the audio thread never allocate
+    for (int order = kMinOrder; order <= kMaxOrder; ++order)
+        mFfts[static_cast<size_t>(order - kMinOrder)] = std::make_unique<juce::dsp::FFT>(order);
+
+    const size_t maxBins = static_cast<size_t>(kMaxFrameSize / 2 + 1);
+    for (auto& channel : mChannels) {
+        channel.inFifo.assign(static_cast<size_t>(kMaxFrameSize), 0.0f);
+        channel.outFifo.assign(static_cast<size_t>(kMaxFrameSize), 0.0f);
+        channel.dryFifo.assign(static_cast<size_t>(kMaxFrameSize), 0.0f);
+        channel.outAccum.assign(static_cast<size_t>(kMaxFrameSize * 2), 0.0f);
+        channel.lastSpectrum.assign(maxBins * 2, 0.0f);
+        channel.rotation.assign(maxBins, 0.0f);
+        channel.envelope.assign(maxBins, 1.0f);
+        channel.inverseEnvelope.assign(maxBins, 1.0f);
+    }
+    mFftData.assign(static_cast<size_t>(kMaxFrameSize * 2), 0.0f);
+    mSynthData.assign(static_cast<size_t>(kMaxFrameSize * 2), 0.0f);
+    mCepstrum.assign(static_cast<size_t>(kMaxFrameSize * 2), 0.0f);
+    mLifterLength = juce::jmax(4, static_cast<int>(std::round(sampleRate * kLifterSeconds)));
+    mWindow.assign(static_cast<size_t>(kMaxFrameSize), 0.0f);
+    mPower.assign(maxBins, 0.0f);
+    mPeaks.clear();
+    mPeaks.reserve(maxBins);
+
+    mWetGain.reset(sampleRate, 0.02);  // 20ms smoothing
+    mWetGain.setCurrentAndTargetValue(1.0f);
+    setRiseTime(50.0f);
+
+    updateFrame();
+    mCurrentLog2Ratio = mTargetLog2Ratio;
+}
+
+void PhaseVocoderShifter::reset() {
+    clearState();
+    mCurrentLog2Ratio = 0.0;
+}
+
+void PhaseVocoderShifter::clearState() {
+    for (auto& channel : mChannels) {
+        std::fill(channel.inFifo.begin(), channel.inFifo.end(), 0.0f);
+        std::fill(channel.outFifo.begin(), channel.outFifo.end(), 0.0f);
+        std::fill(channel.dryFifo.begin(), channel.dryFifo.end(), 0.0f);
+        std::fill(channel.outAccum.begin(), channel.outAccum.end(), 0.0f);
+        std::fill(channel.lastSpectrum.begin(), channel.lastSpectrum.end(), 0.0f);
+        std::fill(channel.rotation.begin(), channel.rotation.end(), 0.0f);
+        channel.primed = false;
+        channel.envelopeValid = false;
+    }
+    mFifoPos = mFrameSize - mHopSize;
+    mHopCount = 0;
+}
+
+void PhaseVocoderShifter::setFrameSize(int fftOrder) {
+    fftOrder = juce::jlimit(kMinOrder, kMaxOrder, fftOrder);
+    if (fftOrder == mFftOrder)
+        return;
+
+    mFftOrder = fftOrder;
+    mFrameSize = 1 << fftOrder;
+    mHopSize = mFrameSize / mOverlap;
+    if (!mWindow.empty())
+        updateFrame();
+}
+
+void PhaseVocoderShifter::updateFrame() {
+    // Periodic Hann: analysis x synthesis windows overlap-add to 3/8 * overlap
+    for (int i = 0; i < mFrameSize; ++i)
+        mWindow[static_cast<size_t>(i)] = 0.5f * (1.0f - std::cos(kTwoPi * static_cast<float>(i) / static_cast<float>(mFrameSize)));
+    mOutputScale = 1.0f / (0.375f * static_cast<float>(mOverlap));
+    clearState();
+}
+
+void PhaseVocoderShifter::setOverlap(int overlap) {
+    overlap = overlap >= 8 ? 8 : 4;
+    if (overlap == mOverlap)
+        return;
+
+    mOverlap = overlap;
+    mHopSize = mFrameSize / mOverlap;
+    if (!mWindow.empty())
+        updateFrame();
+}
+
+void PhaseVocoderShifter::setOctaveMode(int mode) {
+    // mode: 0=-2oct, 1=-1oct, 2=0oct, 3=+1oct, 4=+2oct
+    mTargetLog2Ratio = static_cast<double>(juce::jlimit(0, 4, mode) - 2);
+}
+
+void PhaseVocoderShifter::setFormantPreserve(bool enabled) {
+    if (enabled && !mFormantPreserve) {
+        for (auto& channel : mChannels)
+            channel.envelopeValid = false;
+    }
+    mFormantPreserve = enabled;
+}
+
+void PhaseVocoderShifter::setEngage(bool engaged) {
+    mWetGain.setTargetValue(engaged ? 1.0f : 0.0f);
+}
+
+void PhaseVocoderShifter::setRiseTime(float ms) {
+    double riseSamples = (ms * mSampleRate) / 1000.0;
+    if (riseSamples < 1.0) riseSamples = 1.0;
+    mGlideLog2Decay = -1.0 / (riseSamples * std::log(2.0));
+}
+
+void PhaseVocoderShifter::processStereo(float* leftChannel, float* rightChannel, int numSamples) {
+    if (numSamples <= 0 || mWindow.empty())
+        return;
+
+    // Glide in the log2 domain, same response as the granular engine; the
+    // ratio is only needed once per hop
+    const double remaining = mCurrentLog2Ratio - mTargetLog2Ratio;
+    if (std::abs(remaining) > 0.0) {
+        mCurrentLog2Ratio = mTargetLog2Ratio + remaining * FastMath::fastExp2(mGlideLog2Decay * numSamples);
+        if (std::abs(mCurrentLog2Ratio - mTargetLog2Ratio) < 1.0e-7)
+            mCurrentLog2Ratio = mTargetLog2Ratio;
+    }
+    const float ratio = static_cast<float>(FastMath::fastExp2(mCurrentLog2Ratio + mModulationOffset / 12.0));
+
+    auto& left = mChannels[0];
+    auto& right = mChannels[1];
+    const int fifoStart = mFrameSize - mHopSize;
+
+    for (int sample = 0; sample < numSamples; ++sample) {
+        const float wet = mWetGain.getNextValue();
+        const size_t writeIndex = static_cast<size_t>(mFifoPos);
+        const size_t readIndex = static_cast<size_t>(mFifoPos - fifoStart);
+
+        left.inFifo[writeIndex] = leftChannel[sample];
+        right.inFifo[writeIndex] = rightChannel[sample];
+
+        // Dry signal delayed by the reported latency so engage fades stay aligned
+        leftChannel[sample] = left.dryFifo[readIndex] * (1.0f - wet) + left.outFifo[readIndex] * wet;
+        rightChannel[sample] = right.dryFifo[readIndex] * (1.0f - wet) + right.outFifo[readIndex] * wet;
+
+        if (++mFifoPos >= mFrameSize) {
+            mFifoPos = fifoStart;
+
+            // Envelopes are refreshed twice per frame, left and right on
+            // different hops so no hop pays for both
+            const int interval = mOverlap / 2;
+            processFrame(left, ratio, mHopCount == 0);
+            processFrame(right, ratio, mHopCount == interval / 2);
+            mHopCount = (mHopCount + 1) % interval;
+        }
+    }
+}
+
+void PhaseVocoderShifter::processFrame(Channel& channel, float ratio, bool refreshEnvelope) {
+    const int frameSize = mFrameSize;
+    const int hopSize = mHopSize;
+    const int numBins = frameSize / 2 + 1;
+    const float expectedAdvance = kTwoPi * static_cast<float>(hopSize) / static_cast<float>(frameSize);
+    auto& fft = *mFfts[static_cast<size_t>(mFftOrder - kMinOrder)];
+    float* spectrum = mFftData.data();
+    float* synth = mSynthData.data();
+    float* lastSpectrum = channel.lastSpectrum.data();
+    float* power = mPower.data();
+    float* rotation = channel.rotation.data();
+    const float* window = mWindow.data();
+
+    // === Analysis ===
+    for (int i = 0; i < frameSize; ++i)
+        spectrum[i] = channel.inFifo[static_cast<size_t>(i)] * window[i];
+    fft.performRealOnlyForwardTransform(spectrum, true);
+
+    for (int k = 0; k < numBins; ++k)
+        power[k] = spectrum[2 * k] * spectrum[2 * k] + spectrum[2 * k + 1] * spectrum[2 * k + 1];
+
+    if (mFormantPreserve && (refreshEnvelope || !channel.envelopeValid))
+        updateEnvelope(channel);
+
+    // === Peak picking (local maxima over +/-2 bins) ===
+    mPeaks.clear();
+    for (int k = 0; k < numBins; ++k) {
+        const float m = power[k];
+        if (m <= 1.0e-18f)
+            continue;
+        if ((k >= 1 && power[k - 1] >= m) || (k >= 2 && power[k - 2] >= m))
+            continue;
+        if ((k + 1 < numBins && power[k + 1] > m) || (k + 2 < numBins && power[k + 2] > m))
+            continue;
+        mPeaks.push_back(k);
+    }
+
+    // === Synthesis: move each peak region as a block (identity phase locking) ===
+    std::memset(synth, 0, sizeof(float) * static_cast<size_t>(frameSize * 2));
+
+    const int numPeaks = static_cast<int>(mPeaks.size());
+    int regionStart = 0;
+    for (int p = 0; p < numPeaks; ++p) {
+        const int peak = mPeaks[static_cast<size_t>(p)];
+
+        // Region ends at the lowest bin between this peak and the next
+        int regionEnd = numBins - 1;
+        if (p + 1 < numPeaks) {
+            const int nextPeak = mPeaks[static_cast<size_t>(p + 1)];
+            regionEnd = peak;
+            for (int k = peak + 1; k < nextPeak; ++k)
+                if (power[k] < power[regionEnd])
+                    regionEnd = k;
+        }
+
+        // True frequency from the phase advance since the last frame
+        // (bin centre until a previous frame exists)
+        float trueBin = static_cast<float>(peak);
+        if (channel.primed) {
+            const float re = spectrum[2 * peak], im = spectrum[2 * peak + 1];
+            const float lastRe = lastSpectrum[2 * peak], lastIm = lastSpectrum[2 * peak + 1];
+            const float advance = std::atan2(im * lastRe - re * lastIm, re * lastRe + im * lastIm);
+            trueBin += wrapPhase(advance - wrapPhase(expectedAdvance * static_cast<float>(peak))) / expectedAdvance;
+        }
+        const float targetBin = trueBin * ratio;
+        const int shift = juce::roundToInt(targetBin - static_cast<float>(peak));
+
+        // The peak's synthesis phase advances at the shifted frequency: its
+        // offset from the analysis phase grows by the frequency difference.
+        // Regions are disjoint, so the peak's own entry still holds last frame's.
+        const float peakRotation = wrapPhase(rotation[peak] + expectedAdvance * (targetBin - trueBin));
+        const float c = std::cos(peakRotation);
+        const float s = std::sin(peakRotation);
+
+        // Whole region moves rigidly with the peak
+        const int first = juce::jmax(regionStart, -shift);
+        const int last = juce::jmin(regionEnd, numBins - 1 - shift);
+        if (mFormantPreserve) {
+            // Swap the source envelope for the one at the destination bin
+            const float* envelope = channel.envelope.data();
+            const float* inverseEnvelope = channel.inverseEnvelope.data();
+            for (int k = first; k <= last; ++k) {
+                const float gain = juce::jmin(kMaxFormantGain, envelope[k + shift] * inverseEnvelope[k]);
+                const float re = spectrum[2 * k] * gain, im = spectrum[2 * k + 1] * gain;
+                synth[2 * (k + shift)] += re * c - im * s;
+                synth[2 * (k + shift) + 1] += re * s + im * c;
+            }
+        } else {
+            for (int k = first; k <= last; ++k) {
+                const float re = spectrum[2 * k], im = spectrum[2 * k + 1];
+                synth[2 * (k + shift)] += re * c - im * s;
+                synth[2 * (k + shift) + 1] += re * s + im * c;
+            }
+        }
+        for (int k = regionStart; k <= regionEnd; ++k)
+            rotation[k] = peakRotation;
+        regionStart = regionEnd + 1;
+    }
+    std::memcpy(lastSpectrum, spectrum, sizeof(float) * static_cast<size_t>(numBins * 2));
+    channel.primed = true;
+
+    // === Overlap-add ===
+    fft.performRealOnlyInverseTransform(synth);
+
+    float* accum = channel.outAccum.data();
+    for (int i = 0; i < frameSize; ++i)
+        accum[i] += synth[i] * window[i] * mOutputScale;
+
+    std::memcpy(channel.outFifo.data(), accum, sizeof(float) * static_cast<size_t>(hopSize));
+    std::memcpy(channel.dryFifo.data(), channel.inFifo.data(), sizeof(float) * static_cast<size_t>(hopSize));
+    std::memmove(accum, accum + hopSize, sizeof(float) * static_cast<size_t>(frameSize));
+    std::memmove(channel.inFifo.data(), channel.inFifo.data() + hopSize,
+                 sizeof(float) * static_cast<size_t>(frameSize - hopSize));
+}
+
+void PhaseVocoderShifter::updateEnvelope(Channel& channel) {
+    const int frameSize = mFrameSize;
+    const int numBins = frameSize / 2 + 1;
+    auto& fft = *mFfts[static_cast<size_t>(mFftOrder - kMinOrder)];
+    float* cepstrum = mCepstrum.data();
+    const float* power = mPower.data();
+
+    // Real cepstrum of the current frame: log2 magnitude as an even spectrum
+    for (int k = 0; k < numBins; ++k) {
+        cepstrum[2 * k] = 0.5f * std::log2(power[k] + kPowerFloor);
+        cepstrum[2 * k + 1] = 0.0f;
+    }
+    fft.performRealOnlyInverseTransform(cepstrum);
+
+    // Lifter: the low quefrencies are the envelope, the pitch harmonics sit above
+    const int lifter = juce::jmin(mLifterLength, frameSize / 2 - 1);
+    std::fill(cepstrum + lifter, cepstrum + frameSize - lifter + 1, 0.0f);
+    fft.performRealOnlyForwardTransform(cepstrum, true);
+
+    for (int k = 0; k < numBins; ++k) {
+        const float envelope = FastMath::fastExp2(cepstrum[2 * k]);
+        channel.envelope[static_cast<size_t>(k)] = envelope;
+        channel.inverseEnvelope[static_cast<size_t>(k)] = 1.0f / envelope;
+    }
+    channel.envelopeValid = true;
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+/**
+ * PhaseVocoderShifter - FFT phase-vocoder alternative to the granular
+ * shifter for large shifts on sustained, polyphonic material.
+ *
+ * Each hop the last frameSize input samples are Hann-windowed and
+ * transformed. Spectral peaks are found and every bin is assigned to the
+ * region of its nearest peak; each region is moved as a whole to the peak's
+ * shifted frequency and rotated by the peak's accumulated phase offset
+ * (identity phase locking), so partials keep their shape instead of
+ * smearing. At unity ratio the rotation stays zero and the output is the
+ * input delayed. Phases are only measured at peaks and each region is
+ * rotated as a complex multiply, so the per-bin work is a few multiply-adds. Frames are overlap-added with a Hann synthesis window.
+ *
+ * Formant mode: a cepstrally smoothed spectral envelope is measured every
+ * few hops (channels on alternate hops) and every moved bin is rescaled by
+ * the envelope at its destination over the envelope at its source, so the
+ * partials move but the vocal-tract resonances stay put.
+ *
+ * All frame sizes are allocated in prepare(), switching size or overlap
+ * only clears state. Latency is one frame: the first hop of each frame's
+ * output belongs to its oldest input.
+ */
+class PhaseVocoderShifter {
+public:
+    static constexpr int kMinOrder = 10;  // 1024
+    static constexpr int kMaxOrder = 12;  // 4096
+    static constexpr int kMaxFrameSize = 1 << kMaxOrder;
+
+    PhaseVocoderShifter() = default;
+    ~PhaseVocoderShifter() = default;
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    // FFT order (10-12 = 1024-4096 samples), overlap 4 or 8 (hop = frame / overlap)
+    void setFrameSize(int fftOrder);
+    void setOverlap(int overlap);
+
+    int getFrameSize() const { return mFrameSize; }
+    int getHopSize() const { return mHopSize; }
+
+    // Delay of the wet (and internally blended dry) signal
+    int getLatencySamples() const { return mFrameSize; }
+
+    void setOctaveMode(int mode);       // 0=-2oct ... 4=+2oct
+    void setEngage(bool engaged);
+    void setRiseTime(float ms);
+    void setModulation(double modSemitones) { mModulationOffset = modSemitones; }
+    void setFormantPreserve(bool enabled);
+
+    // Modulation is held for the whole call (one control period or block)
+    void processStereo(float* leftChannel, float* rightChannel, int numSamples);
+
+private:
+    struct Channel {
+        std::vector<float> inFifo;          // Last frameSize input samples
+        std::vector<float> outFifo;         // Finished output, hop at a time
+        std::vector<float> dryFifo;         // Input aligned with outFifo
+        std::vector<float> outAccum;        // Overlap-add accumulator
+        std::vector<float> lastSpectrum;    // Previous analysis frame, interleaved complex
+        std::vector<float> rotation;        // Synthesis - analysis phase per bin
+        std::vector<float> envelope;        // Smoothed magnitude per bin (formant mode)
+        std::vector<float> inverseEnvelope;
+        bool primed = false;                // lastSpectrum holds a previous frame
+        bool envelopeValid = false;
+    };
+
+    void processFrame(Channel& channel, float ratio, bool refreshEnvelope);
+    void updateEnvelope(Channel& channel);
+    void updateFrame();  // Rebuilds the window for the current size and clears state
+    void clearState();
+
+    // Hot state
+    double mCurrentLog2Ratio = 0.0;
+    double mTargetLog2Ratio = 0.0;
+    double mGlideLog2Decay = 0.0;
+    double mModulationOffset = 0.0;
+    int mFrameSize = 2048;
+    int mHopSize = 512;
+    int mFftOrder = 11;
+    int mOverlap = 4;
+    int mFifoPos = 0;
+    int mHopCount = 0;                 // Envelope refresh schedule, counts hops
+    int mLifterLength = 72;            // Cepstral cutoff in samples
+    bool mFormantPreserve = false;
+    float mOutputScale = 1.0f / 1.5f;  // Window overlap-add gain at 4x
+    juce::SmoothedValue<float> mWetGain{1.0f};
+
+    std::array<Channel, 2> mChannels;
+
+    // Shared frame scratch (one channel is processed at a time)
+    std::vector<float> mFftData;            // 2 * frameSize, analysis spectrum
+    std::vector<float> mSynthData;          // 2 * frameSize, shifted spectrum
+    std::vector<float> mCepstrum;           // 2 * frameSize, envelope scratch
+    std::vector<float> mWindow;
+    std::vector<float> mPower;              // |X|^2 per bin
+    std::vector<int> mPeaks;
+
+    std::array<std::unique_ptr<juce::dsp::FFT>, kMaxOrder - kMinOrder + 1> mFfts;
+    double mSampleRate = 44100.0;
+};
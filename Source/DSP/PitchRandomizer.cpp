@@ -1,4 +1,5 @@
 #include "PitchRandomizer.h"
+#include <cmath>
 
 void PitchRandomizer::prepare(double sampleRate) {
     mSampleRate = sampleRate;
@@ -36,17 +37,18 @@ void PitchRandomizer::setSeed(uint32_t seed) {
     mRandom.setSeed(static_cast<juce::int64>(seed));
 }
 
-float PitchRandomizer::process() {
+float PitchRandomizer::process(int numSamples) {
     if (mRandomRange <= 0.0f) {
         return 0.0f;
     }
 
-    float phaseIncrement = mRandomRate / static_cast<float>(mSampleRate);
+    // numSamples > 1 advances a whole control period at once
+    float phaseIncrement = mRandomRate * static_cast<float>(numSamples) / static_cast<float>(mSampleRate);
     mPhase += phaseIncrement;
 
     // Generate new random target at each cycle
     if (mPhase >= 1.0f) {
-        mPhase -= 1.0f;
+        mPhase -= std::floor(mPhase);
         mPreviousTarget = mCurrentTarget;
         // Random value between -range and +range
         mCurrentTarget = (mRandom.nextFloat() * 2.0f - 1.0f) * mRandomRange;
@@ -65,5 +67,5 @@ float PitchRandomizer::process() {
     }
 
     mSmoothedOutput.setTargetValue(output);
-    return mSmoothedOutput.getNextValue();
+    return mSmoothedOutput.skip(numSamples);
 }
@@ -15,7 +15,8 @@ public:
     void setSmooth(float amount);          // 0-1
     void setMode(Mode mode);
     void setSeed(uint32_t seed);
-    float process();  // Returns pitch offset in semitones
+    float process(int numSamples = 1);  // Returns pitch offset in semitones
+    bool isActive() const { return mRandomRange > 0.0f; }  // process() returns 0 otherwise
 
 private:
     double mSampleRate = 44100.0;
@@ -11,6 +11,10 @@ void PitchSlideEngine::reset() {
     mTriggered = false;
     mReleasing = false;
     mAutoPhase = 0.0f;
+    mGliding = false;
+    mGlidePhase = 0.0f;
+    mGlideFrom = 0.0f;
+    mGlideTo = 0.0f;
     mCurrentOffset.setCurrentAndTargetValue(0.0f);
 }
 
@@ -50,18 +54,38 @@ void PitchSlideEngine::release() {
     }
 }
 
+void PitchSlideEngine::glideTo(float semitones) {
+    mGlideFrom = mCurrentOffset.getCurrentValue();
+    mGlideTo = juce::jlimit(-24.0f, 24.0f, semitones);
+    mGlidePhase = 0.0f;
+    mGliding = true;
+}
+
+float PitchSlideEngine::getPeakOffset() const {
+    // S-curve glides stay between their endpoints
+    if (mGliding)
+        return mGlidePhase >= 1.0f ? mGlideTo : juce::jmax(mGlideFrom, mGlideTo);
+    return mCurrentOffset.getCurrentValue();
+}
+
+bool PitchSlideEngine::isActive() const {
+    return mAutoSlide || mTriggered || mGliding || mManualPosition > 0.0f || mDirection == Both
+        || std::abs(mCurrentOffset.getCurrentValue()) > 0.0f;
+}
+
 float PitchSlideEngine::sCurve(float x) {
     // Smooth S-curve using smoothstep
     x = juce::jlimit(0.0f, 1.0f, x);
     return x * x * (3.0f - 2.0f * x);
 }
 
-float PitchSlideEngine::process() {
+float PitchSlideEngine::process(int numSamples) {
     float targetOffset = 0.0f;
+    // numSamples > 1 advances a whole control period at once
+    const float phaseIncrement = static_cast<float>(numSamples) / (mSlideTime * 0.001f * static_cast<float>(mSampleRate));
 
     if (mAutoSlide) {
         // Auto slide mode - continuous oscillation
-        float phaseIncrement = 1.0f / (mSlideTime * 0.001f * static_cast<float>(mSampleRate));
         mAutoPhase += phaseIncrement;
         if (mAutoPhase >= 1.0f) mAutoPhase -= 1.0f;
 
@@ -84,8 +108,6 @@ float PitchSlideEngine::process() {
         }
     } else if (mTriggered) {
         // Manual trigger mode
-        float phaseIncrement = 1.0f / (mSlideTime * 0.001f * static_cast<float>(mSampleRate));
-        
         if (!mReleasing) {
             mEnvelopePhase += phaseIncrement;
             if (mEnvelopePhase >= 1.0f) {
@@ -112,6 +134,12 @@ float PitchSlideEngine::process() {
                 targetOffset = curveValue * mSlideRange;
                 break;
         }
+    } else if (mGliding) {
+        // Note glide: from wherever the offset was towards the new target
+        mGlidePhase = juce::jmin(1.0f, mGlidePhase + phaseIncrement);
+        targetOffset = mGlideFrom + (mGlideTo - mGlideFrom) * sCurve(mGlidePhase);
+        if (mGlidePhase >= 1.0f && juce::approximatelyEqual(mGlideTo, 0.0f))
+            mGliding = false;  // Back home, manual position takes over again
     } else {
         // Manual position control
         float curveValue = sCurve(mManualPosition);
@@ -129,5 +157,5 @@ float PitchSlideEngine::process() {
     }
 
     mCurrentOffset.setTargetValue(targetOffset);
-    return mCurrentOffset.getNextValue();
+    return mCurrentOffset.skip(numSamples);
 }
@@ -18,7 +18,10 @@ public:
     void setReturn(bool enabled);
     void trigger();
     void release();
-    float process();  // Returns current pitch offset in semitones
+    void glideTo(float semitones);  // S-curve glide from the current offset (MIDI notes)
+    bool isActive() const;          // process() may return a non-zero offset
+    float getPeakOffset() const;    // Highest offset the current glide reaches
+    float process(int numSamples = 1);  // Returns current pitch offset in semitones
 
 private:
     float sCurve(float x);  // S-curve for natural glides
@@ -36,4 +39,8 @@ private:
     bool mTriggered = false;
     bool mReleasing = false;
     float mAutoPhase = 0.0f;
+    bool mGliding = false;       // glideTo() target set (held once reached)
+    float mGlidePhase = 0.0f;
+    float mGlideFrom = 0.0f;
+    float mGlideTo = 0.0f;
 };
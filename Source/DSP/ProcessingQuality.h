@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * ProcessingQuality - Global CPU/quality tier shared by the DSP modules.
+ * - Eco:    linear interpolation everywhere, coarse control rate
+ * - Normal: linear grains, Hermite only in Deep chorus (pre-tier behaviour)
+ * - HQ:     Hermite interpolation everywhere, fine control rate,
+ *           2x oversampled nonlinear stages (saturation, drive, output clip)
+ *
+ * HQ is selected automatically while the host renders offline.
+ */
+enum class ProcessingQuality
+{
+    Eco = 0,
+    Normal,
+    HQ
+};
+
+namespace QualitySettings
+{
+    // Samples between modulation/pitch-ratio updates
+    inline int getControlInterval(ProcessingQuality quality)
+    {
+        switch (quality)
+        {
+            case ProcessingQuality::Eco:    return 64;
+            case ProcessingQuality::HQ:     return 8;
+            case ProcessingQuality::Normal:
+            default:                        return 32;
+        }
+    }
+
+    inline bool usesOversampling(ProcessingQuality quality)
+    {
+        return quality == ProcessingQuality::HQ;
+    }
+}
@@ -3,11 +3,21 @@
 
 void Saturation::prepare(double sampleRate) {
     mSampleRate = sampleRate;
+    mSmoothingRate = sampleRate;
     mSmoothDrive.reset(sampleRate, 0.02);
     mSmoothMix.reset(sampleRate, 0.02);
     reset();
 }
 
+void Saturation::setOversamplingFactor(int factor) {
+    const double rate = mSampleRate * factor;
+    if (!juce::approximatelyEqual(rate, mSmoothingRate)) {
+        mSmoothingRate = rate;
+        mSmoothDrive.reset(rate, 0.02);
+        mSmoothMix.reset(rate, 0.02);
+    }
+}
+
 void Saturation::reset() {
     mSmoothDrive.setCurrentAndTargetValue(mDrive);
     mSmoothMix.setCurrentAndTargetValue(mMix);
@@ -24,8 +34,13 @@ void Saturation::setMix(float mix) {
 }
 
 void Saturation::process(juce::AudioBuffer<float>& buffer) {
-    const int numChannels = buffer.getNumChannels();
-    const int numSamples = buffer.getNumSamples();
+    auto block = juce::dsp::AudioBlock<float>(buffer);
+    process(block);
+}
+
+void Saturation::process(juce::dsp::AudioBlock<float>& block) {
+    const int numChannels = static_cast<int>(block.getNumChannels());
+    const int numSamples = static_cast<int>(block.getNumSamples());
 
     for (int sample = 0; sample < numSamples; ++sample) {
         float drive = mSmoothDrive.getNextValue();
@@ -37,7 +52,7 @@ void Saturation::process(juce::AudioBuffer<float>& buffer) {
         float gain = 1.0f + drive * 9.0f;
 
         for (int ch = 0; ch < numChannels; ++ch) {
-            float* data = buffer.getWritePointer(ch);
+            float* data = block.getChannelPointer(static_cast<size_t>(ch));
             float dry = data[sample];
             
             // Apply gain and soft clip with tanh
@@ -10,10 +10,13 @@ public:
     void reset();
     void setDrive(float drive);  // 0-1
     void setMix(float mix);      // 0-1
+    void setOversamplingFactor(int factor);  // Smoothers tick at the processing rate
     void process(juce::AudioBuffer<float>& buffer);
+    void process(juce::dsp::AudioBlock<float>& block);  // Also used on oversampled blocks
 
 private:
     double mSampleRate = 44100.0;
+    double mSmoothingRate = 44100.0;
     float mDrive = 0.0f;
     float mMix = 1.0f;
     
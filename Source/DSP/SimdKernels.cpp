@@ -0,0 +1,368 @@
+#include "SimdKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define SWARMNESS_SIMD_X86 1
+ #include <immintrin.h>
+ #if defined(_MSC_VER) && !defined(__clang__)
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+#else
+ #define SWARMNESS_SIMD_X86 0
+#endif
+
+// Per-function ISA targeting keeps the rest of the target on baseline flags
+// (and keeps the arm64 slice of the macOS universal build compiling)
+#if defined(_MSC_VER) && !defined(__clang__)
+ #define SWARMNESS_TARGET(isa)
+#else
+ #define SWARMNESS_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace {
+    // tanh continued fraction truncated at depth 10 ([11/10] Pade),
+    // max error ~6e-7 once the input is clamped to +-9
+    constexpr float kTanhClamp = 9.0f;
+    constexpr float kN0 = 13749310575.0f, kN1 = 1964187225.0f, kN2 = 64324260.0f,
+                    kN3 = 675675.0f, kN4 = 2145.0f;
+    constexpr float kD0 = 13749310575.0f, kD1 = 6547290750.0f, kD2 = 413513100.0f,
+                    kD3 = 7567560.0f, kD4 = 45045.0f, kD5 = 66.0f;
+
+    // ---- Scalar reference ------------------------------------------------
+
+    void mixDryWetScalar(float* wet, const float* dry, const float* mix, const float* gain, int numSamples) {
+        for (int i = 0; i < numSamples; ++i)
+            wet[i] = (dry[i] * (1.0f - mix[i]) + wet[i] * mix[i]) * gain[i];
+    }
+
+    void applyGainRampScalar(float* data, const float* gain, int numSamples) {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] *= gain[i];
+    }
+
+    // Exact reference: the Scalar table keeps std::tanh
+    void softClipScalar(float* data, float inputGain, float outputGain, int numSamples) {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = std::tanh(data[i] * inputGain) * outputGain;
+    }
+
+    // Tails of the vector variants, same rational tanh as their lanes
+    void softClipTail(float* data, float inputGain, float outputGain, int numSamples) {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = SimdKernels::fastTanh(data[i] * inputGain) * outputGain;
+    }
+
+    float dotProductScalar(const float* a, const float* b, int numSamples) {
+        float sum = 0.0f;
+        for (int i = 0; i < numSamples; ++i)
+            sum += a[i] * b[i];
+        return sum;
+    }
+
+#if SWARMNESS_SIMD_X86
+    // ---- SSE2 (4 lanes) --------------------------------------------------
+
+    SWARMNESS_TARGET("sse2") inline __m128 tanhSSE2(__m128 x) {
+        x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-kTanhClamp)), _mm_set1_ps(kTanhClamp));
+        const __m128 y = _mm_mul_ps(x, x);
+        __m128 num = _mm_add_ps(y, _mm_set1_ps(kN4));
+        num = _mm_add_ps(_mm_mul_ps(num, y), _mm_set1_ps(kN3));
+        num = _mm_add_ps(_mm_mul_ps(num, y), _mm_set1_ps(kN2));
+        num = _mm_add_ps(_mm_mul_ps(num, y), _mm_set1_ps(kN1));
+        num = _mm_add_ps(_mm_mul_ps(num, y), _mm_set1_ps(kN0));
+        __m128 den = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kD5), y), _mm_set1_ps(kD4));
+        den = _mm_add_ps(_mm_mul_ps(den, y), _mm_set1_ps(kD3));
+        den = _mm_add_ps(_mm_mul_ps(den, y), _mm_set1_ps(kD2));
+        den = _mm_add_ps(_mm_mul_ps(den, y), _mm_set1_ps(kD1));
+        den = _mm_add_ps(_mm_mul_ps(den, y), _mm_set1_ps(kD0));
+        const __m128 t = _mm_div_ps(_mm_mul_ps(x, num), den);
+        return _mm_min_ps(_mm_max_ps(t, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    }
+
+    SWARMNESS_TARGET("sse2")
+    void mixDryWetSSE2(float* wet, const float* dry, const float* mix, const float* gain, int numSamples) {
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4) {
+            const __m128 m = _mm_loadu_ps(mix + i);
+            const __m128 d = _mm_loadu_ps(dry + i);
+            const __m128 w = _mm_loadu_ps(wet + i);
+            const __m128 blended = _mm_add_ps(_mm_mul_ps(d, _mm_sub_ps(_mm_set1_ps(1.0f), m)), _mm_mul_ps(w, m));
+            _mm_storeu_ps(wet + i, _mm_mul_ps(blended, _mm_loadu_ps(gain + i)));
+        }
+        mixDryWetScalar(wet + i, dry + i, mix + i, gain + i, numSamples - i);
+    }
+
+    SWARMNESS_TARGET("sse2")
+    void applyGainRampSSE2(float* data, const float* gain, int numSamples) {
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+            _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(gain + i)));
+        applyGainRampScalar(data + i, gain + i, numSamples - i);
+    }
+
+    SWARMNESS_TARGET("sse2")
+    void softClipSSE2(float* data, float inputGain, float outputGain, int numSamples) {
+        const __m128 in = _mm_set1_ps(inputGain);
+        const __m128 out = _mm_set1_ps(outputGain);
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+            _mm_storeu_ps(data + i, _mm_mul_ps(tanhSSE2(_mm_mul_ps(_mm_loadu_ps(data + i), in)), out));
+        softClipTail(data + i, inputGain, outputGain, numSamples - i);
+    }
+
+    SWARMNESS_TARGET("sse2")
+    float dotProductSSE2(const float* a, const float* b, int numSamples) {
+        __m128 acc = _mm_setzero_ps();
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, acc);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + dotProductScalar(a + i, b + i, numSamples - i);
+    }
+
+    // ---- AVX2 (8 lanes) --------------------------------------------------
+
+    SWARMNESS_TARGET("avx2") inline __m256 tanhAVX2(__m256 x) {
+        x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-kTanhClamp)), _mm256_set1_ps(kTanhClamp));
+        const __m256 y = _mm256_mul_ps(x, x);
+        __m256 num = _mm256_add_ps(y, _mm256_set1_ps(kN4));
+        num = _mm256_add_ps(_mm256_mul_ps(num, y), _mm256_set1_ps(kN3));
+        num = _mm256_add_ps(_mm256_mul_ps(num, y), _mm256_set1_ps(kN2));
+        num = _mm256_add_ps(_mm256_mul_ps(num, y), _mm256_set1_ps(kN1));
+        num = _mm256_add_ps(_mm256_mul_ps(num, y), _mm256_set1_ps(kN0));
+        __m256 den = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kD5), y), _mm256_set1_ps(kD4));
+        den = _mm256_add_ps(_mm256_mul_ps(den, y), _mm256_set1_ps(kD3));
+        den = _mm256_add_ps(_mm256_mul_ps(den, y), _mm256_set1_ps(kD2));
+        den = _mm256_add_ps(_mm256_mul_ps(den, y), _mm256_set1_ps(kD1));
+        den = _mm256_add_ps(_mm256_mul_ps(den, y), _mm256_set1_ps(kD0));
+        const __m256 t = _mm256_div_ps(_mm256_mul_ps(x, num), den);
+        return _mm256_min_ps(_mm256_max_ps(t, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+    }
+
+    SWARMNESS_TARGET("avx2")
+    void mixDryWetAVX2(float* wet, const float* dry, const float* mix, const float* gain, int numSamples) {
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8) {
+            const __m256 m = _mm256_loadu_ps(mix + i);
+            const __m256 d = _mm256_loadu_ps(dry + i);
+            const __m256 w = _mm256_loadu_ps(wet + i);
+            const __m256 blended = _mm256_add_ps(_mm256_mul_ps(d, _mm256_sub_ps(_mm256_set1_ps(1.0f), m)),
+                                                 _mm256_mul_ps(w, m));
+            _mm256_storeu_ps(wet + i, _mm256_mul_ps(blended, _mm256_loadu_ps(gain + i)));
+        }
+        mixDryWetScalar(wet + i, dry + i, mix + i, gain + i, numSamples - i);
+    }
+
+    SWARMNESS_TARGET("avx2")
+    void applyGainRampAVX2(float* data, const float* gain, int numSamples) {
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+            _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_loadu_ps(gain + i)));
+        applyGainRampScalar(data + i, gain + i, numSamples - i);
+    }
+
+    SWARMNESS_TARGET("avx2")
+    void softClipAVX2(float* data, float inputGain, float outputGain, int numSamples) {
+        const __m256 in = _mm256_set1_ps(inputGain);
+        const __m256 out = _mm256_set1_ps(outputGain);
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+            _mm256_storeu_ps(data + i, _mm256_mul_ps(tanhAVX2(_mm256_mul_ps(_mm256_loadu_ps(data + i), in)), out));
+        softClipTail(data + i, inputGain, outputGain, numSamples - i);
+    }
+
+    SWARMNESS_TARGET("avx2")
+    float dotProductAVX2(const float* a, const float* b, int numSamples) {
+        __m256 acc = _mm256_setzero_ps();
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        const __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, half);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + dotProductScalar(a + i, b + i, numSamples - i);
+    }
+
+    // ---- AVX-512F (16 lanes) ---------------------------------------------
+
+    // Min/max through the zero-masked forms, whose fallback lanes are
+    // defined (the plain ones warn under GCC -Wall with per-function targets)
+    SWARMNESS_TARGET("avx512f") inline __m512 minAVX512(__m512 a, __m512 b) {
+        return _mm512_maskz_min_ps(static_cast<__mmask16>(0xffff), a, b);
+    }
+
+    SWARMNESS_TARGET("avx512f") inline __m512 maxAVX512(__m512 a, __m512 b) {
+        return _mm512_maskz_max_ps(static_cast<__mmask16>(0xffff), a, b);
+    }
+
+    SWARMNESS_TARGET("avx512f") inline __m512 tanhAVX512(__m512 x) {
+        x = minAVX512(maxAVX512(x, _mm512_set1_ps(-kTanhClamp)), _mm512_set1_ps(kTanhClamp));
+        const __m512 y = _mm512_mul_ps(x, x);
+        __m512 num = _mm512_add_ps(y, _mm512_set1_ps(kN4));
+        num = _mm512_add_ps(_mm512_mul_ps(num, y), _mm512_set1_ps(kN3));
+        num = _mm512_add_ps(_mm512_mul_ps(num, y), _mm512_set1_ps(kN2));
+        num = _mm512_add_ps(_mm512_mul_ps(num, y), _mm512_set1_ps(kN1));
+        num = _mm512_add_ps(_mm512_mul_ps(num, y), _mm512_set1_ps(kN0));
+        __m512 den = _mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(kD5), y), _mm512_set1_ps(kD4));
+        den = _mm512_add_ps(_mm512_mul_ps(den, y), _mm512_set1_ps(kD3));
+        den = _mm512_add_ps(_mm512_mul_ps(den, y), _mm512_set1_ps(kD2));
+        den = _mm512_add_ps(_mm512_mul_ps(den, y), _mm512_set1_ps(kD1));
+        den = _mm512_add_ps(_mm512_mul_ps(den, y), _mm512_set1_ps(kD0));
+        const __m512 t = _mm512_div_ps(_mm512_mul_ps(x, num), den);
+        return minAVX512(maxAVX512(t, _mm512_set1_ps(-1.0f)), _mm512_set1_ps(1.0f));
+    }
+
+    SWARMNESS_TARGET("avx512f")
+    void mixDryWetAVX512(float* wet, const float* dry, const float* mix, const float* gain, int numSamples) {
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16) {
+            const __m512 m = _mm512_loadu_ps(mix + i);
+            const __m512 d = _mm512_loadu_ps(dry + i);
+            const __m512 w = _mm512_loadu_ps(wet + i);
+            const __m512 blended = _mm512_add_ps(_mm512_mul_ps(d, _mm512_sub_ps(_mm512_set1_ps(1.0f), m)),
+                                                 _mm512_mul_ps(w, m));
+            _mm512_storeu_ps(wet + i, _mm512_mul_ps(blended, _mm512_loadu_ps(gain + i)));
+        }
+        mixDryWetScalar(wet + i, dry + i, mix + i, gain + i, numSamples - i);
+    }
+
+    SWARMNESS_TARGET("avx512f")
+    void applyGainRampAVX512(float* data, const float* gain, int numSamples) {
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+            _mm512_storeu_ps(data + i, _mm512_mul_ps(_mm512_loadu_ps(data + i), _mm512_loadu_ps(gain + i)));
+        applyGainRampScalar(data + i, gain + i, numSamples - i);
+    }
+
+    SWARMNESS_TARGET("avx512f")
+    void softClipAVX512(float* data, float inputGain, float outputGain, int numSamples) {
+        const __m512 in = _mm512_set1_ps(inputGain);
+        const __m512 out = _mm512_set1_ps(outputGain);
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+            _mm512_storeu_ps(data + i, _mm512_mul_ps(tanhAVX512(_mm512_mul_ps(_mm512_loadu_ps(data + i), in)), out));
+        softClipTail(data + i, inputGain, outputGain, numSamples - i);
+    }
+
+    SWARMNESS_TARGET("avx512f")
+    float dotProductAVX512(const float* a, const float* b, int numSamples) {
+        __m512 acc = _mm512_setzero_ps();
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+            acc = _mm512_add_ps(acc, _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+        // Reduced through memory: with per-function targeting, GCC's reduce,
+        // extract and cast intrinsics warn about their undefined upper lanes
+        alignas(64) float lanes[16];
+        _mm512_store_ps(lanes, acc);
+        float sum = 0.0f;
+        for (int lane = 0; lane < 8; ++lane)
+            sum += lanes[lane] + lanes[lane + 8];
+        return sum + dotProductScalar(a + i, b + i, numSamples - i);
+    }
+#endif
+
+#if SWARMNESS_SIMD_X86
+    // CPUID only says the CPU has the registers; the OS must also save them
+    // on context switches (OSXSAVE set and the XCR0 state bits enabled)
+    constexpr unsigned long long kXcr0Avx = 0x6;      // XMM, YMM
+    constexpr unsigned long long kXcr0Avx512 = 0xe6;  // + opmask, ZMM 0-15 upper, ZMM 16-31
+
+    SWARMNESS_TARGET("xsave") unsigned long long readXcr0() {
+        return static_cast<unsigned long long>(_xgetbv(0));
+    }
+
+    bool osSavesState(unsigned long long mask) {
+        unsigned int ecx = 0;
+       #if defined(_MSC_VER) && !defined(__clang__)
+        int regs[4] = {};
+        __cpuid(regs, 1);
+        ecx = static_cast<unsigned int>(regs[2]);
+       #else
+        unsigned int eax = 0, ebx = 0, edx = 0;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+       #endif
+        constexpr unsigned int kOsxsave = 1u << 27;
+        return (ecx & kOsxsave) != 0 && (readXcr0() & mask) == mask;
+    }
+#endif
+
+    SimdKernels::Table makeTable(SimdKernels::Isa isa) {
+        SimdKernels::Table table;
+        table.isa = SimdKernels::Isa::Scalar;
+        table.mixDryWet = mixDryWetScalar;
+        table.applyGainRamp = applyGainRampScalar;
+        table.softClip = softClipScalar;
+        table.dotProduct = dotProductScalar;
+
+       #if SWARMNESS_SIMD_X86
+        switch (isa) {
+            case SimdKernels::Isa::SSE2:
+                table = { isa, mixDryWetSSE2, applyGainRampSSE2, softClipSSE2, dotProductSSE2 };
+                break;
+            case SimdKernels::Isa::AVX2:
+                table = { isa, mixDryWetAVX2, applyGainRampAVX2, softClipAVX2, dotProductAVX2 };
+                break;
+            case SimdKernels::Isa::AVX512:
+                table = { isa, mixDryWetAVX512, applyGainRampAVX512, softClipAVX512, dotProductAVX512 };
+                break;
+            case SimdKernels::Isa::Scalar:
+            default:
+                break;
+        }
+       #else
+        juce::ignoreUnused(isa);
+       #endif
+
+        return table;
+    }
+}
+
+float SimdKernels::fastTanh(float x) {
+    x = juce::jlimit(-kTanhClamp, kTanhClamp, x);
+    const float y = x * x;
+    const float num = (((((y + kN4) * y + kN3) * y + kN2) * y + kN1) * y + kN0);
+    const float den = (((((kD5 * y + kD4) * y + kD3) * y + kD2) * y + kD1) * y + kD0);
+    return juce::jlimit(-1.0f, 1.0f, x * num / den);
+}
+
+SimdKernels::Isa SimdKernels::getBestSupportedIsa() {
+   #if SWARMNESS_SIMD_X86
+    if (juce::SystemStats::hasAVX512F() && osSavesState(kXcr0Avx512)) return Isa::AVX512;
+    if (juce::SystemStats::hasAVX2() && osSavesState(kXcr0Avx))       return Isa::AVX2;
+    if (juce::SystemStats::hasSSE2())    return Isa::SSE2;
+   #endif
+    return Isa::Scalar;
+}
+
+const SimdKernels::Table& SimdKernels::getTable(Isa isa) {
+    static const Table tables[] = {
+        makeTable(Isa::Scalar),
+        makeTable(Isa::SSE2),
+        makeTable(Isa::AVX2),
+        makeTable(Isa::AVX512)
+    };
+
+    // Never hand out a variant the CPU can't execute
+    if (static_cast<int>(isa) > static_cast<int>(getBestSupportedIsa()))
+        isa = getBestSupportedIsa();
+
+    return tables[static_cast<int>(isa)];
+}
+
+const SimdKernels::Table& SimdKernels::select() {
+    static const Isa best = getBestSupportedIsa();
+    return getTable(best);
+}
+
+const char* SimdKernels::getIsaName(Isa isa) {
+    switch (isa) {
+        case Isa::SSE2:   return "SSE2";
+        case Isa::AVX2:   return "AVX2";
+        case Isa::AVX512: return "AVX-512";
+        case Isa::Scalar:
+        default:          return "Scalar";
+    }
+}
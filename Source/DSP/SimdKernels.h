@@ -0,0 +1,59 @@
+#pragma once
+#include <JuceHeader.h>
+
+/**
+ * SimdKernels - Runtime-dispatched block kernels for the processor's
+ * vectorisable loops (dry/wet mix, gain ramps, tanh soft clipping) and the
+ * pitch shifter's correlation searches.
+ *
+ * The widest instruction set the CPU supports and the OS has enabled is
+ * detected once (CPUID via juce::SystemStats, plus the XCR0 register state
+ * for AVX2/AVX-512) and the matching function table is handed out by
+ * select(). The Scalar table is the exact reference and clips with
+ * std::tanh; the vector variants share a rational tanh that stays within
+ * ~6e-7 of it.
+ *
+ * Recursive stages (biquads, DC blockers, grain/chorus interpolation) carry
+ * per-sample state and stay scalar inside their own modules.
+ */
+namespace SimdKernels
+{
+    enum class Isa
+    {
+        Scalar = 0,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+
+    struct Table
+    {
+        Isa isa = Isa::Scalar;
+
+        // wet[i] = (dry[i] * (1 - mix[i]) + wet[i] * mix[i]) * gain[i]
+        void (*mixDryWet)(float* wet, const float* dry, const float* mix, const float* gain, int numSamples) = nullptr;
+
+        // data[i] *= gain[i]
+        void (*applyGainRamp)(float* data, const float* gain, int numSamples) = nullptr;
+
+        // data[i] = tanh(data[i] * inputGain) * outputGain
+        void (*softClip)(float* data, float inputGain, float outputGain, int numSamples) = nullptr;
+
+        // sum(a[i] * b[i]), used for correlation searches
+        float (*dotProduct)(const float* a, const float* b, int numSamples) = nullptr;
+    };
+
+    // Widest ISA this CPU (and build) supports
+    Isa getBestSupportedIsa();
+
+    // Table for a specific ISA; falls back to scalar when it is unavailable
+    const Table& getTable(Isa isa);
+
+    // Table for the best supported ISA (detected on first call)
+    const Table& select();
+
+    // The vector kernels' tanh approximation
+    float fastTanh(float x);
+
+    const char* getIsaName(Isa isa);
+}
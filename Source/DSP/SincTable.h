@@ -0,0 +1,120 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+
+/**
+ * SincTable - Shared polyphase windowed-sinc interpolation kernels.
+ * kTaps-point Kaiser-windowed sinc (cutoff 0.9 x Nyquist) at kPhases
+ * fractional positions, plus one extra row so kernels between two phases
+ * can be blended. One copy for the whole plugin, built at load time.
+ *
+ * Tap n of a kernel weights the sample at intPos - kTapsBefore + n.
+ * Rows are normalised to unity DC gain and 32-byte aligned so they load
+ * straight into SIMD registers.
+ */
+class SincTable
+{
+public:
+    static constexpr int kTaps = 8;
+    static constexpr int kTapsBefore = kTaps / 2 - 1;   // Taps left of intPos
+    static constexpr int kPhases = 256;
+
+    // Kernel rows either side of frac (0-1) and the blend between them
+    struct Kernel
+    {
+        const float* a;
+        const float* b;
+        float t;
+    };
+
+    static Kernel getKernel(float frac) noexcept
+    {
+        const float position = frac * static_cast<float>(kPhases);
+        const int phase = juce::jlimit(0, kPhases - 1, static_cast<int>(position));
+        return { row(phase), row(phase + 1), position - static_cast<float>(phase) };
+    }
+
+    // Mono read: x points at the sample kTapsBefore before intPos, kTaps contiguous samples
+    static float interpolate(const float* x, float frac) noexcept
+    {
+        const Kernel k = getKernel(frac);
+       #if JUCE_USE_SSE_INTRINSICS
+        const __m128 t = _mm_set1_ps(k.t);
+        __m128 acc = _mm_setzero_ps();
+        for (int i = 0; i < kTaps; i += 4)
+        {
+            const __m128 a = _mm_load_ps(k.a + i);
+            const __m128 c = _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(_mm_load_ps(k.b + i), a)));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + i), c));
+        }
+        acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+        acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+        return _mm_cvtss_f32(acc);
+       #elif JUCE_USE_ARM_NEON
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (int i = 0; i < kTaps; i += 4)
+        {
+            const float32x4_t a = vld1q_f32(k.a + i);
+            const float32x4_t c = vmlaq_n_f32(a, vsubq_f32(vld1q_f32(k.b + i), a), k.t);
+            acc = vmlaq_f32(acc, vld1q_f32(x + i), c);
+        }
+        const float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+        return vget_lane_f32(vpadd_f32(sum, sum), 0);
+       #else
+        float acc = 0.0f;
+        for (int i = 0; i < kTaps; ++i)
+            acc += x[i] * (k.a[i] + k.t * (k.b[i] - k.a[i]));
+        return acc;
+       #endif
+    }
+
+    static const float* row(int phase) noexcept
+    {
+        return table.data() + phase * kTaps;
+    }
+
+private:
+    using Table = std::array<float, (kPhases + 1) * kTaps>;
+
+    static Table build()
+    {
+        constexpr double kCutoff = 0.9;  // Fraction of Nyquist
+        constexpr double kBeta = 7.0;    // Kaiser shape, ~70 dB sidelobes
+        const double halfSpan = kTaps * 0.5;
+
+        auto besselI0 = [](double x)
+        {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 32; ++k)
+            {
+                term *= (x * 0.5 / k) * (x * 0.5 / k);
+                sum += term;
+            }
+            return sum;
+        };
+
+        Table t{};
+        for (int p = 0; p <= kPhases; ++p)
+        {
+            const double frac = static_cast<double>(p) / kPhases;
+            double sum = 0.0;
+            for (int n = 0; n < kTaps; ++n)
+            {
+                const double x = static_cast<double>(n - kTapsBefore) - frac;
+                const double arg = juce::MathConstants<double>::pi * kCutoff * x;
+                const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(arg) / arg;
+                const double r = x / halfSpan;
+                const double w = std::abs(r) < 1.0 ? besselI0(kBeta * std::sqrt(1.0 - r * r)) / besselI0(kBeta) : 0.0;
+                t[static_cast<size_t>(p * kTaps + n)] = static_cast<float>(sinc * w);
+                sum += sinc * w;
+            }
+            for (int n = 0; n < kTaps; ++n)
+                t[static_cast<size_t>(p * kTaps + n)] = static_cast<float>(t[static_cast<size_t>(p * kTaps + n)] / sum);
+        }
+        return t;
+    }
+
+    alignas(32) static inline const Table table = build();
+};
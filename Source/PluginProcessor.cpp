@@ -1,6 +1,18 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+namespace {
+    // Renders a smoother's next numSamples values for the block kernels
+    void fillRamp(juce::SmoothedValue<float>& smoother, float* dest, int numSamples) {
+        if (!smoother.isSmoothing()) {
+            juce::FloatVectorOperations::fill(dest, smoother.getTargetValue(), numSamples);
+            return;
+        }
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = smoother.getNextValue();
+    }
+}
+
 SwarmnesssAudioProcessor::SwarmnesssAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
     : AudioProcessor(BusesProperties()
@@ -42,18 +54,42 @@ SwarmnesssAudioProcessor::SwarmnesssAudioProcessor()
     pFlowSpeed = mAPVTS.getRawParameterValue("flowSpeed");
     pGlobalBypass = mAPVTS.getRawParameterValue("globalBypass");
     pGlobalEngage = mAPVTS.getRawParameterValue("globalEngage");
+    pQuality = mAPVTS.getRawParameterValue("quality");
+    pLookahead = mAPVTS.getRawParameterValue("lookahead");
+    pOnsetSync = mAPVTS.getRawParameterValue("onsetSync");
+    pFreeze = mAPVTS.getRawParameterValue("freeze");
+    pReverse = mAPVTS.getRawParameterValue("reverse");
+    pCloud = mAPVTS.getRawParameterValue("cloud");
+    pCloudDensity = mAPVTS.getRawParameterValue("cloudDensity");
+    pTape = mAPVTS.getRawParameterValue("tape");
+    pGrainCount = mAPVTS.getRawParameterValue("grainCount");
+    pGrainMode = mAPVTS.getRawParameterValue("grainMode");
+    pPitchEngine = mAPVTS.getRawParameterValue("pitchEngine");
+    pFftSize = mAPVTS.getRawParameterValue("fftSize");
+    pFftOverlap = mAPVTS.getRawParameterValue("fftOverlap");
+    pFormant = mAPVTS.getRawParameterValue("formant");
+    pVoices = mAPVTS.getRawParameterValue("voices");
+    pLatencyBudget = mAPVTS.getRawParameterValue("latencyBudget");
+    pGrainWindow = mAPVTS.getRawParameterValue("grainWindow");
+    pVoice2Interval = mAPVTS.getRawParameterValue("voice2Interval");
+    pVoice3Interval = mAPVTS.getRawParameterValue("voice3Interval");
+    pVoice4Interval = mAPVTS.getRawParameterValue("voice4Interval");
+    pFixedRate = mAPVTS.getRawParameterValue("fixedRate");
+    pSincInterp = mAPVTS.getRawParameterValue("sincInterp");
     
     // Initialize dirty tracking after all parameters are set up
     mPresetManager->initializeDirtyTracking();
 }
 
-SwarmnesssAudioProcessor::~SwarmnesssAudioProcessor() {}
+SwarmnesssAudioProcessor::~SwarmnesssAudioProcessor() {
+    cancelPendingUpdate();
+}
 
 const juce::String SwarmnesssAudioProcessor::getName() const {
     return JucePlugin_Name;
 }
 
-bool SwarmnesssAudioProcessor::acceptsMidi() const { return false; }
+bool SwarmnesssAudioProcessor::acceptsMidi() const { return true; }
 bool SwarmnesssAudioProcessor::producesMidi() const { return false; }
 bool SwarmnesssAudioProcessor::isMidiEffect() const { return false; }
 double SwarmnesssAudioProcessor::getTailLengthSeconds() const { return 0.1; }
@@ -72,14 +108,33 @@ void SwarmnesssAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBl
     spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
     spec.numChannels = static_cast<juce::uint32>(getTotalNumOutputChannels());
 
+    // Internal rate for the pitch section and chorus (host rate unless the
+    // fixed-rate mode is on and the host runs at 88.2k or above)
+    mInternalStages = getRequestedInternalStages(sampleRate);
+    mRatePrepareRequested = false;
+    mCapturePrepareRequested = false;
+    mPitchResampler.prepare(static_cast<int>(spec.numChannels), samplesPerBlock, mInternalStages);
+    mChorusResampler.prepare(static_cast<int>(spec.numChannels), samplesPerBlock, mInternalStages);
+    mInternalBuffer.setSize(static_cast<int>(spec.numChannels), mPitchResampler.getMaxInternalBlockSize());
+
+    const double internalRate = sampleRate / mPitchResampler.getFactor();
+    auto internalSpec = spec;
+    internalSpec.sampleRate = internalRate;
+    internalSpec.maximumBlockSize = static_cast<juce::uint32>(mPitchResampler.getMaxInternalBlockSize());
+
     // Prepare original Noise Glitch DSP modules
-    mPitchShifter.prepare(sampleRate, samplesPerBlock);
-    mModGen.prepare(sampleRate);
-    mRingModL.prepare(sampleRate);
-    mRingModR.prepare(sampleRate);
+    mPitchShifter.prepare(internalRate, static_cast<int>(internalSpec.maximumBlockSize));
+    mSpectralShifter.setFrameSize(PhaseVocoderShifter::kMinOrder + static_cast<int>(pFftSize->load()));
+    mSpectralShifter.setOverlap(4 << static_cast<int>(pFftOverlap->load()));
+    mSpectralShifter.prepare(internalRate, static_cast<int>(internalSpec.maximumBlockSize));
+    mAnalogOctave.prepare(internalRate);
+    mPitchEngine = static_cast<PitchEngine>(static_cast<int>(pPitchEngine->load()));
+    mModGen.prepare(internalRate);
+    mRingModL.prepare(internalRate);
+    mRingModR.prepare(internalRate);
     
     // Prepare DC blockers (high-pass at 20Hz)
-    auto dcCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 20.0);
+    auto dcCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(internalRate, 20.0);
     mDCBlockerL.coefficients = dcCoeffs;
     mDCBlockerR.coefficients = dcCoeffs;
     mDCBlockerL.reset();
@@ -90,29 +145,155 @@ void SwarmnesssAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBl
     mGainSmoothed.reset(sampleRate, 0.02);
 
     // Prepare additional Swarmness modules
-    mPitchRandomizer.prepare(sampleRate);
+    mPitchRandomizer.prepare(internalRate);
+    mSlideEngine.prepare(internalRate);
+    mNumHeldNotes = 0;
+    mPitchBend = 0.0f;
+    mWhammy = 0.0f;
     mModulation.prepare(sampleRate);
     mFilterEngine.prepare(spec);
-    mChorusEngine.prepare(spec);
+    mChorusEngine.prepare(internalSpec);
     mFlowEngine.prepare(spec);
     mDCBlocker.prepare(sampleRate);
     mSaturation.prepare(sampleRate);
 
+    // HQ tier oversamplers (allocated here, only run when HQ is active)
+    mSaturationOversampler = std::make_unique<juce::dsp::Oversampling<float>>(
+        spec.numChannels, 1, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+    mOutputOversampler = std::make_unique<juce::dsp::Oversampling<float>>(
+        spec.numChannels, 1, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+    mSaturationOversampler->initProcessing(static_cast<size_t>(samplesPerBlock));
+    mOutputOversampler->initProcessing(static_cast<size_t>(samplesPerBlock));
+    mActiveQuality = getEffectiveQuality();
+
     mDryBuffer.setSize(spec.numChannels, samplesPerBlock);
+    mRampBuffer.setSize(kNumRamps, samplesPerBlock);
+
+    // Widest vector ISA on this machine (CPUID, detected once)
+    mKernels = &SimdKernels::select();
+
+    // Latency compensation delays (250ms headroom)
+    const int maxDelay = static_cast<int>(sampleRate * 0.25);
+    mDryDelay.prepare(spec);
+    mDryDelay.setMaximumDelayInSamples(maxDelay);
+    mBypassDelay.prepare(spec);
+    mBypassDelay.setMaximumDelayInSamples(maxDelay);
+    mDryFadeLength = static_cast<int>(sampleRate * 0.02);  // 20ms dry crossfade on latency changes
+    mDryDelayFrom = mDryDelayTo = getPitchLatencySamples();
+    mDryFadePos = mDryFadeLength;
+    mDryDelay.setDelay(static_cast<float>(mDryDelayTo));
+    setLatencySamples(computeLatencySamples(mActiveQuality));  // Off the audio thread here
+    updateLatency(mActiveQuality);
 }
 
 void SwarmnesssAudioProcessor::releaseResources() {
     mPitchShifter.reset();
+    mSpectralShifter.reset();
     mModGen.reset();
     mRingModL.reset();
     mRingModR.reset();
     mPitchRandomizer.reset();
+    mSlideEngine.reset();
     mModulation.reset();
     mFilterEngine.reset();
     mChorusEngine.reset();
     mFlowEngine.reset();
     mDCBlocker.reset();
     mSaturation.reset();
+    if (mSaturationOversampler) mSaturationOversampler->reset();
+    if (mOutputOversampler) mOutputOversampler->reset();
+    mDryDelay.reset();
+    mBypassDelay.reset();
+    mPitchResampler.reset();
+    mChorusResampler.reset();
+}
+
+int SwarmnesssAudioProcessor::getRequestedInternalStages(double sampleRate) const {
+    if (*pFixedRate < 0.5f)
+        return 0;
+    if (sampleRate >= 176400.0)
+        return 2;  // 176.4/192k -> 44.1/48k
+    if (sampleRate >= 88200.0)
+        return 1;  // 88.2/96k -> 44.1/48k
+    return 0;
+}
+
+void SwarmnesssAudioProcessor::handleAsyncUpdate() {
+    // Work the audio thread hands off: the host latency report, the granular
+    // freeze capture ring (adopted by the shifter's next block), and buffers
+    // resized for a new internal rate
+    const int latency = mPendingLatency.load();
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+    if (mCapturePrepareRequested.exchange(false))
+        mPitchShifter.prepareCapture();
+    if (mRatePrepareRequested) {
+        suspendProcessing(true);
+        prepareToPlay(getSampleRate(), getBlockSize());
+        suspendProcessing(false);
+    }
+}
+
+int SwarmnesssAudioProcessor::getPitchLatencySamples() const {
+    // Active engine's delay at the internal rate plus the resampler round trip
+    int engineLatency = 0;
+    if (mPitchEngine == PitchEngine::Spectral)
+        engineLatency = mSpectralShifter.getLatencySamples();
+    else if (mPitchEngine == PitchEngine::Granular)
+        engineLatency = mPitchShifter.getLatencySamples();
+    return engineLatency * mPitchResampler.getFactor() + mPitchResampler.getLatencySamples();
+}
+
+int SwarmnesssAudioProcessor::computeLatencySamples(ProcessingQuality quality) const {
+    // Pitch path: active engine plus the resampler round trip
+    int latency = getPitchLatencySamples();
+    // Chorus runs after the dry/wet mix, so its round trip delays everything
+    latency += mChorusResampler.getLatencySamples();
+    if (QualitySettings::usesOversampling(quality) && mSaturationOversampler && mOutputOversampler) {
+        latency += juce::roundToInt(mSaturationOversampler->getLatencyInSamples()
+                                  + mOutputOversampler->getLatencyInSamples());
+    }
+    return latency;
+}
+
+void SwarmnesssAudioProcessor::updateLatency(ProcessingQuality quality) {
+    // The dry path crossfades to the new pitch delay; the host hears about
+    // the new total from the message thread
+    const int latency = computeLatencySamples(quality);
+    const int dryDelay = getPitchLatencySamples();
+    if (dryDelay != mDryDelayTo) {
+        mDryDelayFrom = 2 * mDryFadePos < mDryFadeLength ? mDryDelayFrom : mDryDelayTo;
+        mDryDelayTo = dryDelay;
+        mDryFadePos = 0;
+    }
+    mBypassDelay.setDelay(static_cast<float>(latency));
+    mPendingLatency.store(latency);
+    if (latency != getLatencySamples())
+        triggerAsyncUpdate();
+}
+
+void SwarmnesssAudioProcessor::processBypassDelay(juce::AudioBuffer<float>& buffer) {
+    // Bypassed audio keeps the reported latency so PDC stays valid
+    const int numChannels = juce::jmin(buffer.getNumChannels(), getTotalNumOutputChannels());
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* data = buffer.getWritePointer(ch);
+        for (int i = 0; i < buffer.getNumSamples(); ++i) {
+            mBypassDelay.pushSample(ch, data[i]);
+            data[i] = mBypassDelay.popSample(ch);
+        }
+    }
+}
+
+void SwarmnesssAudioProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) {
+    juce::ScopedNoDenormals noDenormals;
+    processBypassDelay(buffer);
+}
+
+ProcessingQuality SwarmnesssAudioProcessor::getEffectiveQuality() const {
+    // Offline bounce always renders at the best quality
+    if (isNonRealtime())
+        return ProcessingQuality::HQ;
+    return static_cast<ProcessingQuality>(juce::jlimit(0, 2, static_cast<int>(*pQuality)));
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -150,6 +331,10 @@ void SwarmnesssAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     // This allows both traditional bypass AND momentary "engage" control
     bool isBypassed = (*pGlobalBypass > 0.5f) || (*pGlobalEngage < 0.5f);
     if (isBypassed) {
+        // Keep the note state current so no note hangs after bypass
+        for (const auto metadata : midiMessages)
+            handleMidiMessage(metadata.getMessage());
+        processBypassDelay(buffer);
         return;
     }
 
@@ -163,14 +348,86 @@ void SwarmnesssAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     const float mix = *pMix;
     const float outputGainDb = *pOutputGain * 30.0f - 24.0f;  // -24 to +6 dB
     
+    // Quality tier (Eco / Normal / HQ, HQ forced when rendering offline)
+    const ProcessingQuality quality = getEffectiveQuality();
+    if (quality != mActiveQuality) {
+        mSaturationOversampler->reset();
+        mOutputOversampler->reset();
+        mActiveQuality = quality;
+        updateLatency(quality);
+    }
+    const bool oversample = QualitySettings::usesOversampling(quality);
+    const int controlInterval = QualitySettings::getControlInterval(quality);
+    
+    // Internal rate mode changed: re-prepare off the audio thread
+    if (getRequestedInternalStages(getSampleRate()) != mInternalStages && !mRatePrepareRequested) {
+        mRatePrepareRequested = true;
+        triggerAsyncUpdate();
+    }
+    mPitchShifter.setQuality(quality);
+    mChorusEngine.setQuality(quality);
+    const bool sincInterp = *pSincInterp > 0.5f;
+    mPitchShifter.setSincInterpolation(sincInterp);
+    mChorusEngine.setSincInterpolation(sincInterp);
+    
     // Update smoothed parameters
     mMixSmoothed.setTargetValue(mix);
     mGainSmoothed.setTargetValue(juce::Decibels::decibelsToGain(outputGainDb));
     
-    // Update pitch shifter
+    // Update pitch shifter (the grain size follows the voice targets within
+    // the latency budget; only the budget moves the latency)
+    const int granularLatency = mPitchShifter.getLatencySamples();
+    mPitchShifter.setLatencyBudget(pLatencyBudget->load());
     mPitchShifter.setOctaveMode(octaveMode);
     mPitchShifter.setEngage(octaveActive);
     mPitchShifter.setRiseTime(riseMs);
+    mPitchShifter.setLookahead(*pLookahead > 0.5f);
+    mPitchShifter.setOnsetSync(*pOnsetSync > 0.5f);
+    mPitchShifter.setFreeze(octaveActive && *pFreeze > 0.5f);  // Released while the pitch section is off
+    if (mPitchShifter.isCaptureRequested() && !mCapturePrepareRequested) {
+        mCapturePrepareRequested = true;  // First freeze: allocate the capture ring off the audio thread
+        triggerAsyncUpdate();
+    }
+    mPitchShifter.setReverse(*pReverse > 0.5f);
+    const bool cloud = *pCloud > 0.5f;
+    mPitchShifter.setCloud(cloud);
+    mPitchShifter.setCloudDensity(*pCloudDensity);
+    mPitchShifter.setCloudSpread(panic, chaos);
+    mPitchShifter.setTape(*pTape > 0.5f);
+    mPitchShifter.setGrainCount(2 << static_cast<int>(pGrainCount->load()));  // 2, 4, 8
+    mPitchShifter.setWindowShape(static_cast<GrainWindows::Shape>(static_cast<int>(pGrainWindow->load())));
+    mPitchShifter.setGrainMode(static_cast<GranularPitchShifter::GrainMode>(static_cast<int>(pGrainMode->load())));
+    mPitchShifter.setVoiceInterval(1, pVoice2Interval->load());
+    mPitchShifter.setVoiceInterval(2, pVoice3Interval->load());
+    mPitchShifter.setVoiceInterval(3, pVoice4Interval->load());
+    mPitchShifter.setVoiceCount(static_cast<int>(pVoices->load()));
+    
+    // Pitch engine: granular, phase vocoder or analog octave. Latency budget,
+    // frame size, overlap and engine all change the latency, so any change
+    // re-reports it.
+    const auto engine = static_cast<PitchEngine>(static_cast<int>(pPitchEngine->load()));
+    const bool spectral = engine == PitchEngine::Spectral;
+    const int spectralLatency = mSpectralShifter.getLatencySamples();
+    mSpectralShifter.setFrameSize(PhaseVocoderShifter::kMinOrder + static_cast<int>(pFftSize->load()));  // 1024-4096
+    mSpectralShifter.setOverlap(4 << static_cast<int>(pFftOverlap->load()));  // 4x, 8x
+    mSpectralShifter.setFormantPreserve(*pFormant > 0.5f);
+    if (engine != mPitchEngine) {
+        mPitchEngine = engine;
+        mPitchShifter.reset();
+        mSpectralShifter.reset();
+        mAnalogOctave.reset();
+        updateLatency(quality);
+    } else if (spectral && mSpectralShifter.getLatencySamples() != spectralLatency) {
+        updateLatency(quality);
+    } else if (engine == PitchEngine::Granular && mPitchShifter.getLatencySamples() != granularLatency) {
+        updateLatency(quality);
+    }
+    mSpectralShifter.setOctaveMode(octaveMode);
+    mSpectralShifter.setEngage(octaveActive);
+    mSpectralShifter.setRiseTime(riseMs);
+    mAnalogOctave.setOctaveMode(octaveMode);
+    mAnalogOctave.setEngage(octaveActive);
+    mSlideEngine.setSlideTime(riseMs);  // MIDI note glides (50 ms minimum)
     
     // Update PitchRandomizer (RANGE and SPEED knobs) - only when VOLTAGE section is active
     float randomRange = octaveActive ? pRandomRange->load() : 0.0f;  // Now directly 0-24 semitones (int parameter)
@@ -179,8 +436,11 @@ void SwarmnesssAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     mPitchRandomizer.setRandomRate(randomRate);
     
     // Update modulation generator (original Noise Glitch algorithm)
-    // Modulation is only active when VOLTAGE section (Pitch) is engaged
-    if (octaveActive) {
+    // Modulation is only active when VOLTAGE section (Pitch) is engaged.
+    // In granular cloud mode Rush/Anger scatter the grains instead.
+    if (octaveActive && cloud && engine == PitchEngine::Granular) {
+        mModGen.setParams(0.0f, 0.0f, speed);
+    } else if (octaveActive) {
         mModGen.setParams(panic, chaos, speed);
     } else {
         mModGen.setParams(0.0f, 0.0f, 0.0f);  // Disable modulation when Pitch is off
@@ -193,62 +453,52 @@ void SwarmnesssAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     mRingModL.setAmount(octaveActive ? speed : 0.0f);
     mRingModR.setAmount(octaveActive ? speed : 0.0f);
     
-    // Store dry signal
+    // Store dry signal, delayed to line up with the pitch shifter output;
+    // after a latency change it crossfades from the old delay to the new one
     mDryBuffer.makeCopyOf(buffer, true);
+    for (int ch = 0; ch < mDryBuffer.getNumChannels(); ++ch) {
+        float* dry = mDryBuffer.getWritePointer(ch);
+        for (int i = 0; i < numSamples; ++i) {
+            mDryDelay.pushSample(ch, dry[i]);
+            const int fadePos = mDryFadePos + i;
+            if (fadePos < mDryFadeLength) {
+                const float from = mDryDelay.popSample(ch, static_cast<float>(mDryDelayFrom), false);
+                const float to = mDryDelay.popSample(ch, static_cast<float>(mDryDelayTo));
+                dry[i] = from + (to - from) * static_cast<float>(fadePos) / static_cast<float>(mDryFadeLength);
+            } else {
+                dry[i] = mDryDelay.popSample(ch);
+            }
+        }
+    }
+    mDryFadePos = juce::jmin(mDryFadeLength, mDryFadePos + numSamples);
     
     // Get channel pointers
     float* channelL = buffer.getWritePointer(0);
     float* channelR = numChannels > 1 ? buffer.getWritePointer(1) : channelL;
     
     // === ORIGINAL NOISE GLITCH PROCESSING FLOW ===
-    // Per-sample processing for modulation (only if VOLTAGE section is active)
-    for (int sample = 0; sample < numSamples; ++sample)
-    {
-        float totalPitchMod = 0.0f;
-        
-        if (octaveActive) {
-            // Get modulation values (Panic + Chaos combined pitch modulation)
-            float pitchMod = mModGen.getPitchModulation();
-            
-            // Get random pitch offset from PitchRandomizer (RANGE/SPEED knobs)
-            float randomPitchOffset = mPitchRandomizer.process();
-            
-            // Combine modulations: original Noise Glitch + random pitch
-            totalPitchMod = pitchMod + randomPitchOffset;
-        }
-        
-        // Apply pitch modulation to shifter
-        mPitchShifter.setModulation(totalPitchMod);
+    if (mInternalStages > 0) {
+        // Pitch section at the internal rate
+        auto* const* internal = mInternalBuffer.getArrayOfWritePointers();
+        const int internalChannels = juce::jmin(numChannels, mInternalBuffer.getNumChannels());
+        const int numInternal = mPitchResampler.processDown(buffer.getArrayOfReadPointers(), internal,
+                                                            internalChannels, numSamples);
+        processPitchSection(internal[0], internalChannels > 1 ? internal[1] : internal[0],
+                            internalChannels, numInternal, octaveActive, controlInterval, midiMessages);
+        mPitchResampler.processUp(mInternalBuffer.getArrayOfReadPointers(), numInternal,
+                                  buffer.getArrayOfWritePointers(), internalChannels, numSamples);
+    } else {
+        processPitchSection(channelL, channelR, numChannels, numSamples, octaveActive, controlInterval, midiMessages);
     }
     
-    // Process pitch shifting (stereo)
-    mPitchShifter.processStereo(channelL, channelR, numSamples);
-    
-    // Per-sample post-processing
-    for (int sample = 0; sample < numSamples; ++sample)
-    {
-        // Apply ring modulation (Speed effect) - only active when Pitch is engaged
-        channelL[sample] = mRingModL.processSample(channelL[sample]);
-        if (numChannels > 1)
-            channelR[sample] = mRingModR.processSample(channelR[sample]);
-        
-        // Apply DC blocking
-        channelL[sample] = mDCBlockerL.processSample(channelL[sample]);
-        if (numChannels > 1)
-            channelR[sample] = mDCBlockerR.processSample(channelR[sample]);
-        
-        // Get dry samples
-        float dryL = mDryBuffer.getSample(0, sample);
-        float dryR = numChannels > 1 ? mDryBuffer.getSample(1, sample) : dryL;
-        
-        // Mix dry/wet
-        float currentMix = mMixSmoothed.getNextValue();
-        float currentGain = mGainSmoothed.getNextValue();
-        
-        channelL[sample] = (dryL * (1.0f - currentMix) + channelL[sample] * currentMix) * currentGain;
-        if (numChannels > 1)
-            channelR[sample] = (dryR * (1.0f - currentMix) + channelR[sample] * currentMix) * currentGain;
-    }
+    // Dry/wet mix and output gain: render the smoother ramps, then mix with the vector kernel
+    mRampBuffer.setSize(kNumRamps, numSamples, false, false, true);
+    float* mixRamp = mRampBuffer.getWritePointer(kMixRamp);
+    float* gainRamp = mRampBuffer.getWritePointer(kGainRamp);
+    fillRamp(mMixSmoothed, mixRamp, numSamples);
+    fillRamp(mGainSmoothed, gainRamp, numSamples);
+    for (int ch = 0; ch < numChannels; ++ch)
+        mKernels->mixDryWet(buffer.getWritePointer(ch), mDryBuffer.getReadPointer(ch), mixRamp, gainRamp, numSamples);
     
     // === ADDITIONAL SWARMNESS PROCESSING ===
     
@@ -258,19 +508,48 @@ void SwarmnesssAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     mFilterEngine.process(buffer);
     
     // Saturation (MID BOOST)
-    if (*pSaturation > 0.01f) {
+    // In HQ the oversampler always runs so the reported latency stays constant
+    const bool saturationActive = *pSaturation > 0.01f;
+    if (saturationActive) {
         mSaturation.setDrive(*pSaturation);
         mSaturation.setMix(1.0f);
-        mSaturation.process(buffer);
+    }
+    auto saturationBlock = juce::dsp::AudioBlock<float>(buffer);
+    if (oversample) {
+        auto upsampled = mSaturationOversampler->processSamplesUp(saturationBlock);
+        if (saturationActive) {
+            mSaturation.setOversamplingFactor(static_cast<int>(mSaturationOversampler->getOversamplingFactor()));
+            mSaturation.process(upsampled);
+        }
+        mSaturationOversampler->processSamplesDown(saturationBlock);
+    } else if (saturationActive) {
+        mSaturation.setOversamplingFactor(1);
+        mSaturation.process(saturationBlock);
     }
     
     // Chorus/SWARM modulation (only if engaged)
-    if (*pChorusEngage > 0.5f && *pChorusMix > 0.01f) {
+    const bool chorusActive = *pChorusEngage > 0.5f && *pChorusMix > 0.01f;
+    if (chorusActive) {
         // chorusMode: false=Classic (0), true=Deep (1)
         mChorusEngine.setMode(*pChorusMode > 0.5f ? ChorusEngine::Mode::Deep : ChorusEngine::Mode::Classic);
         mChorusEngine.setRate(0.1f + *pChorusRate * 4.9f);  // 0.1-5 Hz
         mChorusEngine.setDepth(*pChorusDepth);
         mChorusEngine.setMix(*pChorusMix);
+    }
+    if (mInternalStages > 0) {
+        // The round trip always runs so the reported latency stays constant
+        const int internalChannels = juce::jmin(numChannels, mInternalBuffer.getNumChannels());
+        const int numInternal = mChorusResampler.processDown(buffer.getArrayOfReadPointers(),
+                                                             mInternalBuffer.getArrayOfWritePointers(),
+                                                             internalChannels, numSamples);
+        if (chorusActive) {
+            juce::AudioBuffer<float> internalView(mInternalBuffer.getArrayOfWritePointers(),
+                                                  internalChannels, numInternal);
+            mChorusEngine.process(internalView);
+        }
+        mChorusResampler.processUp(mInternalBuffer.getArrayOfReadPointers(), numInternal,
+                                   buffer.getArrayOfWritePointers(), internalChannels, numSamples);
+    } else if (chorusActive) {
         mChorusEngine.process(buffer);
     }
     
@@ -280,35 +559,174 @@ void SwarmnesssAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
         mFlowEngine.setMode(*pFlowMode > 0.5f ? FlowEngine::Mode::Pulse : FlowEngine::Mode::Static);
         mFlowEngine.setFlowAmount(*pFlowAmount);
         mFlowEngine.setPulseRate(0.5f + *pFlowSpeed * 19.5f);
-        for (int sample = 0; sample < numSamples; ++sample) {
-            float flowGain = mFlowEngine.process();
-            for (int ch = 0; ch < numChannels; ++ch) {
-                buffer.getWritePointer(ch)[sample] *= flowGain;
+        float* flowRamp = mRampBuffer.getWritePointer(kFlowRamp);
+        for (int sample = 0; sample < numSamples; ++sample)
+            flowRamp[sample] = mFlowEngine.process();
+        for (int ch = 0; ch < numChannels; ++ch)
+            mKernels->applyGainRamp(buffer.getWritePointer(ch), flowRamp, numSamples);
+    }
+    
+    // Drive + final soft clip (oversampled in HQ)
+    auto outputBlock = juce::dsp::AudioBlock<float>(buffer);
+    if (oversample) {
+        auto upsampled = mOutputOversampler->processSamplesUp(outputBlock);
+        applyOutputStage(upsampled, *pDrive);
+        mOutputOversampler->processSamplesDown(outputBlock);
+    } else {
+        applyOutputStage(outputBlock, *pDrive);
+    }
+}
+
+void SwarmnesssAudioProcessor::processPitchSection(float* channelL, float* channelR, int numChannels,
+                                                   int numSamples, bool octaveActive, int controlInterval,
+                                                   const juce::MidiBuffer& midi) {
+    // Modulation is evaluated at control rate; the pitch shifter runs one
+    // control period at a time so each period sees its own modulation value.
+    // Without pitch modulation the whole block is a single period.
+    // MIDI pitch events also end a period, so each one takes effect at its
+    // own sample (host offsets scaled to the internal rate); other MIDI
+    // (clock, program changes, other CCs) leaves the block whole.
+    const bool modulated = octaveActive
+                        && (mModGen.isPitchModulationActive() || mPitchRandomizer.isActive());
+    bool midiDriven = isMidiPitchActive();
+    for (const auto metadata : midi)
+        midiDriven = midiDriven || isMidiPitchMessage(metadata.getMessage());
+    const int period = modulated || midiDriven ? controlInterval : juce::jmax(1, numSamples);
+    const int factor = mPitchResampler.getFactor();
+    auto event = midi.begin();
+    
+    for (int start = 0; start < numSamples;)
+    {
+        int nextEvent = numSamples;
+        for (; event != midi.end(); ++event)
+        {
+            const auto metadata = *event;
+            const int position = metadata.samplePosition / factor;
+            if (position > start && isMidiPitchMessage(metadata.getMessage())) {
+                nextEvent = juce::jmin(position, numSamples);
+                break;
             }
+            handleMidiMessage(metadata.getMessage());
         }
+        
+        const int blockLength = juce::jmin(period, numSamples - start, nextEvent - start);
+        float totalPitchMod = 0.0f;
+        
+        if (midiDriven) {
+            // Note glide, pitch bend and whammy (not gated by VOLTAGE, the dry
+            // path doesn't hear them anyway)
+            totalPitchMod = mSlideEngine.process(blockLength) + mPitchBend + mWhammy;
+        }
+        
+        if (modulated) {
+            // Get modulation values (Panic + Chaos combined pitch modulation)
+            float pitchMod = mModGen.getPitchModulation(blockLength);
+            
+            // Get random pitch offset from PitchRandomizer (RANGE/SPEED knobs)
+            float randomPitchOffset = mPitchRandomizer.process(blockLength);
+            
+            // Combine modulations: original Noise Glitch + random pitch
+            totalPitchMod += pitchMod + randomPitchOffset;
+        }
+        
+        // Apply pitch modulation to the active engine and process this control period
+        // (the analog divider only knows whole octaves and ignores it)
+        if (mPitchEngine == PitchEngine::Spectral) {
+            mSpectralShifter.setModulation(totalPitchMod);
+            mSpectralShifter.processStereo(channelL + start, channelR + start, blockLength);
+        } else if (mPitchEngine == PitchEngine::Analog) {
+            mAnalogOctave.processStereo(channelL + start, channelR + start, blockLength);
+        } else {
+            // The held MIDI offset also sets the anti-alias cutoff
+            mPitchShifter.setHeldOffset(midiDriven ? mSlideEngine.getPeakOffset() + mPitchBend + mWhammy : 0.0f);
+            mPitchShifter.setModulation(totalPitchMod);
+            mPitchShifter.processStereo(channelL + start, channelR + start, blockLength);
+        }
+        start += blockLength;
     }
     
+    // Events past the last internal sample (rounding at the internal rate)
+    for (; event != midi.end(); ++event)
+        handleMidiMessage((*event).getMessage());
+    
+    // The blocker rests while frozen: the loop replays input and adds no offset of its own
+    const bool dcBlock = mPitchEngine != PitchEngine::Granular || !mPitchShifter.isFrozen();
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        // Apply ring modulation (Speed effect) - only active when Pitch is engaged
+        channelL[sample] = mRingModL.processSample(channelL[sample]);
+        if (numChannels > 1)
+            channelR[sample] = mRingModR.processSample(channelR[sample]);
+        
+        // Apply DC blocking
+        if (dcBlock) {
+            channelL[sample] = mDCBlockerL.processSample(channelL[sample]);
+            if (numChannels > 1)
+                channelR[sample] = mDCBlockerR.processSample(channelR[sample]);
+        }
+    }
+}
+
+void SwarmnesssAudioProcessor::handleMidiMessage(const juce::MidiMessage& message) {
+    // Note on: glide to the note's interval from C4 (last-note priority).
+    // Note off: glide back to the previous held note, or home.
+    if (message.isNoteOn()) {
+        const int note = message.getNoteNumber();
+        if (mNumHeldNotes == static_cast<int>(mHeldNotes.size())) {
+            std::copy(mHeldNotes.begin() + 1, mHeldNotes.end(), mHeldNotes.begin());
+            --mNumHeldNotes;
+        }
+        mHeldNotes[static_cast<size_t>(mNumHeldNotes++)] = note;
+        mSlideEngine.glideTo(static_cast<float>(note - 60));
+    } else if (message.isNoteOff()) {
+        const int note = message.getNoteNumber();
+        const auto held = mHeldNotes.begin() + mNumHeldNotes;
+        const auto found = std::find(mHeldNotes.begin(), held, note);
+        if (found == held)
+            return;
+        const bool sounding = found == held - 1;
+        std::copy(found + 1, held, found);
+        --mNumHeldNotes;
+        if (sounding)
+            mSlideEngine.glideTo(mNumHeldNotes > 0 ? static_cast<float>(mHeldNotes[static_cast<size_t>(mNumHeldNotes - 1)] - 60) : 0.0f);
+    } else if (message.isPitchWheel()) {
+        mPitchBend = static_cast<float>(message.getPitchWheelValue() - 8192) / 8192.0f * 2.0f;  // +-2 semitones
+    } else if (message.isAllNotesOff() || message.isAllSoundOff()) {
+        mNumHeldNotes = 0;
+        mSlideEngine.glideTo(0.0f);
+    } else if (message.isController()) {
+        // Mod wheel / expression pedal: whammy sweep up to an octave
+        const int cc = message.getControllerNumber();
+        if (cc == 1 || cc == 11)
+            mWhammy = static_cast<float>(message.getControllerValue()) / 127.0f * 12.0f;
+    }
+}
+
+bool SwarmnesssAudioProcessor::isMidiPitchMessage(const juce::MidiMessage& message) {
+    // The messages handleMidiMessage turns into pitch
+    return message.isNoteOnOrOff() || message.isPitchWheel() || message.isAllNotesOff() || message.isAllSoundOff()
+        || message.isControllerOfType(1) || message.isControllerOfType(11);
+}
+
+bool SwarmnesssAudioProcessor::isMidiPitchActive() const {
+    return mSlideEngine.isActive() || std::abs(mPitchBend) > 0.0f || mWhammy > 0.0f;
+}
+
+void SwarmnesssAudioProcessor::applyOutputStage(juce::dsp::AudioBlock<float>& block, float drive) {
+    const int numChannels = static_cast<int>(block.getNumChannels());
+    const int numSamples = static_cast<int>(block.getNumSamples());
+
     // Drive (soft clipping)
-    float drive = *pDrive;
     if (drive > 0.01f) {
         float driveAmount = 1.0f + drive * 4.0f;
-        for (int ch = 0; ch < numChannels; ++ch) {
-            auto* data = buffer.getWritePointer(ch);
-            for (int i = 0; i < numSamples; ++i) {
-                data[i] = std::tanh(data[i] * driveAmount) / std::tanh(driveAmount);
-            }
-        }
+        float makeup = 1.0f / std::tanh(driveAmount);
+        for (int ch = 0; ch < numChannels; ++ch)
+            mKernels->softClip(block.getChannelPointer(static_cast<size_t>(ch)), driveAmount, makeup, numSamples);
     }
     
     // Final soft clip to prevent harsh clipping (original Noise Glitch)
     for (int ch = 0; ch < numChannels; ++ch)
-    {
-        float* channel = buffer.getWritePointer(ch);
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            channel[sample] = std::tanh(channel[sample]);
-        }
-    }
+        mKernels->softClip(block.getChannelPointer(static_cast<size_t>(ch)), 1.0f, 1.0f, numSamples);
 }
 
 bool SwarmnesssAudioProcessor::hasEditor() const { return true; }
@@ -342,6 +760,44 @@ juce::AudioProcessorValueTreeState::ParameterLayout SwarmnesssAudioProcessor::cr
         "engage", "VOLTAGE On", true));
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "rise", "VOLTAGE Rise", 0.0f, 1.0f, 0.05f));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "lookahead", "VOLTAGE Lookahead", false));  // Transient-aligned grain starts
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "onsetSync", "VOLTAGE Onset Sync", false));  // Grain restarts placed around detected attacks
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "freeze", "VOLTAGE Freeze", false));  // Loop the captured grains (granular engine)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "reverse", "VOLTAGE Reverse", false));  // Grains read backward (granular engine)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "cloud", "VOLTAGE Cloud", false));  // Random grain cloud, scattered by Rush/Anger (granular engine)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "cloudDensity", "VOLTAGE Cloud Density", 0.0f, 1.0f, 0.5f));  // 8-64 overlapping grains
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "tape", "VOLTAGE Tape", false));  // Varispeed read head instead of grains (granular engine)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "grainCount", "VOLTAGE Grains", juce::StringArray{"2", "4", "8"}, 0));  // Overlapping grains
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "grainMode", "VOLTAGE Splice", juce::StringArray{"FIXED", "WSOLA", "PSOLA"}, 0));  // Grain restart placement
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "grainWindow", "VOLTAGE Grain Window", juce::StringArray{"HANN", "TUKEY", "TRAPEZOID", "BLACKMAN"}, 0));  // Shared window tables
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "voices", "VOLTAGE Voices", 1, 4, 1));  // Harmonizer voices on the granular engine
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "latencyBudget", "VOLTAGE Latency Budget", 8, 80, 40));  // ms, granular latency; grains use up to half
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "voice2Interval", "VOLTAGE Voice 2", -24, 24, 7));  // Semitones
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "voice3Interval", "VOLTAGE Voice 3", -24, 24, 12));
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "voice4Interval", "VOLTAGE Voice 4", -24, 24, -12));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "pitchEngine", "VOLTAGE Engine", juce::StringArray{"GRANULAR", "SPECTRAL", "ANALOG"}, 0));  // Granular, phase vocoder or eco divider
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "fftSize", "VOLTAGE FFT Size", juce::StringArray{"1024", "2048", "4096"}, 1));  // Phase vocoder frame
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "fftOverlap", "VOLTAGE FFT Overlap", juce::StringArray{"4x", "8x"}, 0));  // Hop = frame / overlap
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "formant", "VOLTAGE Formant", false));  // Cepstral formant preservation (spectral engine)
 
     // Pitch Randomizer (RANGE and SPEED knobs)
     params.push_back(std::make_unique<juce::AudioParameterInt>(
@@ -400,6 +856,12 @@ juce::AudioProcessorValueTreeState::ParameterLayout SwarmnesssAudioProcessor::cr
         "globalBypass", "Bypass", false));
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         "globalEngage", "Engage", true));  // Inverted bypass for momentary MIDI
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "quality", "Quality", juce::StringArray{"ECO", "NORMAL", "HQ"}, 1));  // HQ forced on offline render
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "fixedRate", "48k Internal", false));  // Pitch + chorus at ~48k when host runs at 88.2k+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "sincInterp", "Sinc Interpolation", false));  // Band-limited grain + chorus reads
 
     return {params.begin(), params.end()};
 }
@@ -1,17 +1,24 @@
 #pragma once
 #include <JuceHeader.h>
 #include "DSP/GranularPitchShifter.h"
+#include "DSP/PhaseVocoderShifter.h"
+#include "DSP/AnalogOctave.h"
 #include "DSP/ModulationGenerator.h"
 #include "DSP/PitchRandomizer.h"
+#include "DSP/PitchSlideEngine.h"
 #include "DSP/Modulation.h"
 #include "DSP/AnalogFilterEngine.h"
 #include "DSP/ChorusEngine.h"
 #include "DSP/FlowEngine.h"
 #include "DSP/DCBlocker.h"
 #include "DSP/Saturation.h"
+#include "DSP/ProcessingQuality.h"
+#include "DSP/HalfbandResampler.h"
+#include "DSP/SimdKernels.h"
 #include "Preset/PresetManager.h"
 
-class SwarmnesssAudioProcessor : public juce::AudioProcessor {
+class SwarmnesssAudioProcessor : public juce::AudioProcessor,
+                                  private juce::AsyncUpdater {
 public:
     SwarmnesssAudioProcessor();
     ~SwarmnesssAudioProcessor() override;
@@ -24,6 +31,7 @@ public:
    #endif
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -51,15 +59,41 @@ public:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
 private:
+    ProcessingQuality getEffectiveQuality() const;
+    void applyOutputStage(juce::dsp::AudioBlock<float>& block, float drive);
+    int getPitchLatencySamples() const;
+    int computeLatencySamples(ProcessingQuality quality) const;
+    void updateLatency(ProcessingQuality quality);
+    void processBypassDelay(juce::AudioBuffer<float>& buffer);
+    void processPitchSection(float* channelL, float* channelR, int numChannels, int numSamples,
+                             bool octaveActive, int controlInterval, const juce::MidiBuffer& midi);
+    void handleMidiMessage(const juce::MidiMessage& message);
+    static bool isMidiPitchMessage(const juce::MidiMessage& message);
+    bool isMidiPitchActive() const;
+    int getRequestedInternalStages(double sampleRate) const;
+    void handleAsyncUpdate() override;  // Latency report, freeze capture allocation and internal rate re-prepare
+
     juce::AudioProcessorValueTreeState mAPVTS;
     std::unique_ptr<PresetManager> mPresetManager;
 
     // DSP Modules - Original Noise Glitch algorithm
     GranularPitchShifter mPitchShifter;
+    PhaseVocoderShifter mSpectralShifter;  // Alternative pitch engine (FFT)
+    AnalogOctave mAnalogOctave;            // Eco pitch engine (divider/rectifier, no latency)
+    enum class PitchEngine { Granular = 0, Spectral, Analog };  // "pitchEngine" choice order
+    PitchEngine mPitchEngine = PitchEngine::Granular;
     ModulationGenerator mModGen;
     RingModulator mRingModL;
     RingModulator mRingModR;
     
+    // MIDI pitch control: notes glide through the slide engine, pitch bend
+    // and the whammy CCs add on top
+    PitchSlideEngine mSlideEngine;
+    std::array<int, 16> mHeldNotes {};  // Last-note priority, oldest first
+    int mNumHeldNotes = 0;
+    float mPitchBend = 0.0f;            // Semitones
+    float mWhammy = 0.0f;               // Semitones
+    
     // Additional Swarmness modules
     PitchRandomizer mPitchRandomizer;
     Modulation mModulation;
@@ -77,6 +111,11 @@ private:
     juce::SmoothedValue<float> mMixSmoothed;
     juce::SmoothedValue<float> mGainSmoothed;
 
+    // HQ tier: 2x oversampling around the nonlinear stages
+    std::unique_ptr<juce::dsp::Oversampling<float>> mSaturationOversampler;
+    std::unique_ptr<juce::dsp::Oversampling<float>> mOutputOversampler;
+    ProcessingQuality mActiveQuality = ProcessingQuality::Normal;
+
     // Parameter pointers
     std::atomic<float>* pOctaveMode = nullptr;
     std::atomic<float>* pEngage = nullptr;
@@ -103,9 +142,57 @@ private:
     std::atomic<float>* pFlowSpeed = nullptr;
     std::atomic<float>* pGlobalBypass = nullptr;
     std::atomic<float>* pGlobalEngage = nullptr;
+    std::atomic<float>* pQuality = nullptr;
+    std::atomic<float>* pLookahead = nullptr;
+    std::atomic<float>* pOnsetSync = nullptr;
+    std::atomic<float>* pFreeze = nullptr;
+    std::atomic<float>* pReverse = nullptr;
+    std::atomic<float>* pCloud = nullptr;
+    std::atomic<float>* pCloudDensity = nullptr;
+    std::atomic<float>* pTape = nullptr;
+    std::atomic<float>* pGrainCount = nullptr;
+    std::atomic<float>* pGrainMode = nullptr;
+    std::atomic<float>* pPitchEngine = nullptr;
+    std::atomic<float>* pFftSize = nullptr;
+    std::atomic<float>* pFftOverlap = nullptr;
+    std::atomic<float>* pFormant = nullptr;
+    std::atomic<float>* pVoices = nullptr;
+    std::atomic<float>* pLatencyBudget = nullptr;
+    std::atomic<float>* pGrainWindow = nullptr;
+    std::atomic<float>* pVoice2Interval = nullptr;
+    std::atomic<float>* pVoice3Interval = nullptr;
+    std::atomic<float>* pVoice4Interval = nullptr;
+    std::atomic<float>* pFixedRate = nullptr;
+    std::atomic<float>* pSincInterp = nullptr;
 
     juce::AudioBuffer<float> mDryBuffer;
     double mCurrentSampleRate = 44100.0;
 
+    // Runtime-dispatched vector kernels and the per-block ramps they consume
+    enum RampIndex { kMixRamp = 0, kGainRamp, kFlowRamp, kNumRamps };
+    const SimdKernels::Table* mKernels = &SimdKernels::getTable(SimdKernels::Isa::Scalar);
+    juce::AudioBuffer<float> mRampBuffer;
+
+    // Latency compensation: dry path follows the pitch shifter delay
+    // (crossfading on a change), bypass path follows the total reported
+    // latency, which reaches the host through handleAsyncUpdate()
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> mDryDelay;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> mBypassDelay;
+    int mDryDelayFrom = 0;
+    int mDryDelayTo = 0;
+    int mDryFadePos = 0;       // Samples into the dry crossfade
+    int mDryFadeLength = 0;
+    std::atomic<int> mPendingLatency { 0 };
+
+    // Fixed internal rate: pitch section and chorus run at ~48 kHz when the
+    // host runs at 88.2k and above (one resampler round trip each)
+    HalfbandResampler mPitchResampler;
+    HalfbandResampler mChorusResampler;
+    juce::AudioBuffer<float> mInternalBuffer;
+    int mInternalStages = 0;
+    // Set on the audio thread, served by handleAsyncUpdate()
+    std::atomic<bool> mRatePrepareRequested { false };
+    std::atomic<bool> mCapturePrepareRequested { false };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SwarmnesssAudioProcessor)
 };